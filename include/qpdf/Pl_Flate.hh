@@ -114,6 +114,8 @@ class QPDF_DLL_CLASS Pl_Flate: public Pipeline
         size_t out_bufsize;
         action_e action;
         bool initialized;
+        // Whether zdata came from the reuse pool and needs a reset instead of an init.
+        bool from_pool{false};
         void* zdata;
         unsigned long long written{0};
         std::function<void(char const*, int)> callback;
@@ -136,6 +136,14 @@ class QPDFJob
 
     // SEE BELOW FOR MORE PUBLIC METHODS AND CLASSES
   private:
+    // Passkey that lets the Config factory methods construct the sub-configuration objects with
+    // std::make_shared, fusing the object and control-block allocations, while keeping the
+    // constructors unusable from outside.
+    struct config_key
+    {
+        explicit config_key() = default;
+    };
+
     // These structures are private but we need to define them before the public Config classes.
     struct CopyAttachmentFrom
     {
@@ -196,10 +204,11 @@ class QPDFJob
         QPDF_DLL
         AttConfig* file(std::string const& parameter);
 
+        AttConfig(config_key, Config*);
+
 #include <qpdf/auto_job_c_att.hh>
 
       private:
-        AttConfig(Config*);
         AttConfig(AttConfig const&) = delete;
 
         Config* config;
@@ -217,10 +226,11 @@ class QPDFJob
         QPDF_DLL
         CopyAttConfig* file(std::string const& parameter);
 
+        CopyAttConfig(config_key, Config*);
+
 #include <qpdf/auto_job_c_copy_att.hh>
 
       private:
-        CopyAttConfig(Config*);
         CopyAttConfig(CopyAttConfig const&) = delete;
 
         Config* config;
@@ -241,10 +251,11 @@ class QPDFJob
         PagesConfig* pageSpec(
             std::string const& filename, std::string const& range, char const* password = nullptr);
 
+        PagesConfig(config_key, Config*);
+
 #include <qpdf/auto_job_c_pages.hh>
 
       private:
-        PagesConfig(Config*);
         PagesConfig(PagesConfig const&) = delete;
 
         Config* config;
@@ -259,10 +270,11 @@ class QPDFJob
         QPDF_DLL
         Config* endUnderlayOverlay();
 
+        UOConfig(config_key, Config*);
+
 #include <qpdf/auto_job_c_uo.hh>
 
       private:
-        UOConfig(Config*);
         UOConfig(UOConfig const&) = delete;
 
         Config* config;
@@ -279,10 +291,11 @@ class QPDFJob
         QPDF_DLL
         EncConfig* file(std::string const& parameter);
 
+        EncConfig(config_key, Config*);
+
 #include <qpdf/auto_job_c_enc.hh>
 
       private:
-        EncConfig(Config*);
         EncConfig(EncConfig const&) = delete;
 
         Config* config;
@@ -426,8 +439,8 @@ class QPDFJob
     enum password_mode_e { pm_bytes, pm_hex_bytes, pm_unicode, pm_auto };
 
     // Helper functions
-    static void usage(std::string const& msg);
-    static JSON json_schema(int json_version, std::set<std::string>* keys = nullptr);
+    [[noreturn]] static void usage(std::string const& msg);
+    static JSON json_schema(int json_version, std::vector<std::string> const* keys = nullptr);
     static void parse_object_id(std::string const& objspec, bool& trailer, int& obj, int& gen);
     void parseRotationParameter(std::string const&);
     std::vector<int> parseNumrange(char const* range, int max);
@@ -110,10 +110,9 @@ class QPDFObjGen
         add(QPDFObjGen og)
         {
             if (og.isIndirect()) {
-                if (count(og)) {
-                    return false;
-                }
-                emplace(og);
+                // emplace reports whether the insertion took place, so membership test and
+                // insertion cost a single tree probe.
+                return emplace(og).second;
             }
             return true;
         }
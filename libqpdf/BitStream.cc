@@ -51,6 +51,12 @@ BitStream::getBitsInt(size_t nbits)
         QIntC::to_uint(read_bits(this->p, this->bit_offset, this->bits_available, nbits)));
 }
 
+size_t
+BitStream::bitsAvailable() const
+{
+    return bits_available;
+}
+
 void
 BitStream::skipToNextByte()
 {
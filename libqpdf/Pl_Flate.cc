@@ -2,6 +2,7 @@
 
 #include <climits>
 #include <cstring>
+#include <vector>
 #include <zlib.h>
 
 #include <qpdf/QIntC.hh>
@@ -15,6 +16,62 @@
 namespace
 {
     unsigned long long memory_limit_{0};
+
+    // Initialized zlib streams kept for reuse. A fresh deflateInit allocates the whole internal
+    // window state; resetting an already-initialized stream keeps those allocations, which
+    // matters when compressing many small streams. Thread-local so distinct qpdf objects can be
+    // used from different threads without locking.
+    struct zstream_pool
+    {
+        static size_t constexpr limit = 8;
+
+        std::vector<z_stream*> deflate_streams;
+        std::vector<z_stream*> inflate_streams;
+
+        ~zstream_pool()
+        {
+            for (auto* zs: deflate_streams) {
+                deflateEnd(zs);
+                delete zs;
+            }
+            for (auto* zs: inflate_streams) {
+                inflateEnd(zs);
+                delete zs;
+            }
+        }
+    };
+
+    zstream_pool&
+    pool()
+    {
+        thread_local zstream_pool p;
+        return p;
+    }
+
+    // Return a z_stream to the pool for reuse, or end and free it if the pool is full or the
+    // stream was never initialized.
+    void
+    recycle(void*& zdata, bool is_deflate, bool initialized)
+    {
+        auto* zs = static_cast<z_stream*>(zdata);
+        zdata = nullptr;
+        if (!zs) {
+            return;
+        }
+        if (initialized) {
+            auto& streams = is_deflate ? pool().deflate_streams : pool().inflate_streams;
+            if (streams.size() < zstream_pool::limit) {
+                streams.push_back(zs);
+                return;
+            }
+            if (is_deflate) {
+                deflateEnd(zs);
+            } else {
+                inflateEnd(zs);
+            }
+        }
+        delete zs;
+    }
 } // namespace
 
 int Pl_Flate::compression_level = Z_DEFAULT_COMPRESSION;
@@ -26,20 +83,32 @@ Pl_Flate::Members::Members(size_t out_bufsize, action_e action) :
     zdata(nullptr)
 {
     this->outbuf = QUtil::make_shared_array<unsigned char>(out_bufsize);
-    // Indirect through zdata to reach the z_stream so we don't have to include zlib.h in
-    // Pl_Flate.hh.  This means people using shared library versions of qpdf don't have to have zlib
-    // development files available, which particularly helps in a Windows environment.
-    zdata = new z_stream;
 
     if (out_bufsize > UINT_MAX) {
         throw std::runtime_error(
             "Pl_Flate: zlib doesn't support buffer sizes larger than unsigned int");
     }
 
+    // Indirect through zdata to reach the z_stream so we don't have to include zlib.h in
+    // Pl_Flate.hh.  This means people using shared library versions of qpdf don't have to have zlib
+    // development files available, which particularly helps in a Windows environment.
+    auto& streams = action == a_deflate ? pool().deflate_streams : pool().inflate_streams;
+    if (streams.empty()) {
+        zdata = new z_stream;
+    } else {
+        zdata = streams.back();
+        streams.pop_back();
+        from_pool = true;
+    }
+
     z_stream& zstream = *(static_cast<z_stream*>(this->zdata));
-    zstream.zalloc = nullptr;
-    zstream.zfree = nullptr;
-    zstream.opaque = nullptr;
+    if (!from_pool) {
+        // A pooled stream keeps the allocator fields zlib filled in at init; clearing them
+        // would make the reset fail its state check.
+        zstream.zalloc = nullptr;
+        zstream.zfree = nullptr;
+        zstream.opaque = nullptr;
+    }
     zstream.next_in = nullptr;
     zstream.avail_in = 0;
     zstream.next_out = this->outbuf.get();
@@ -52,17 +121,7 @@ Pl_Flate::Members::Members(size_t out_bufsize, action_e action) :
 
 Pl_Flate::Members::~Members()
 {
-    if (initialized) {
-        z_stream& zstream = *(static_cast<z_stream*>(zdata));
-        if (action == a_deflate) {
-            deflateEnd(&zstream);
-        } else {
-            inflateEnd(&zstream);
-        }
-    }
-
-    delete static_cast<z_stream*>(this->zdata);
-    zdata = nullptr;
+    recycle(zdata, action == a_deflate, initialized || from_pool);
 }
 
 Pl_Flate::Pl_Flate(
@@ -149,9 +208,22 @@ Pl_Flate::handleData(unsigned char const* data, size_t len, int flush)
 # pragma GCC diagnostic ignored "-Wold-style-cast"
 #endif
         if (m->action == a_deflate) {
-            err = deflateInit(&zstream, compression_level);
+            if (m->from_pool) {
+                err = deflateReset(&zstream);
+                if (err == Z_OK) {
+                    // Reset keeps the previous stream's compression level; the global level may
+                    // have changed since then.
+                    err = deflateParams(&zstream, compression_level, Z_DEFAULT_STRATEGY);
+                }
+            } else {
+                err = deflateInit(&zstream, compression_level);
+            }
         } else {
-            err = inflateInit(&zstream);
+            if (m->from_pool) {
+                err = inflateReset(&zstream);
+            } else {
+                err = inflateInit(&zstream);
+            }
         }
 #if ((defined(__GNUC__) && ((__GNUC__ * 100) + __GNUC_MINOR__) >= 406) || defined(__clang__))
 # pragma GCC diagnostic pop
@@ -232,18 +304,11 @@ Pl_Flate::finish()
             finish_zopfli();
         } else if (m->outbuf.get()) {
             if (m->initialized) {
-                z_stream& zstream = *(static_cast<z_stream*>(m->zdata));
                 unsigned char buf[1];
                 buf[0] = '\0';
                 handleData(buf, 0, Z_FINISH);
-                int err = Z_OK;
-                if (m->action == a_deflate) {
-                    err = deflateEnd(&zstream);
-                } else {
-                    err = inflateEnd(&zstream);
-                }
+                recycle(m->zdata, m->action == a_deflate, true);
                 m->initialized = false;
-                checkError("End", err);
             }
 
             m->outbuf = nullptr;
@@ -229,10 +229,14 @@ Pl_PNGFilter::encodeRow()
     unsigned char ch = 2;
     next()->write(&ch, 1);
     if (prev_row) {
+        // Compute the whole difference row before writing rather than issuing one pipeline write
+        // per byte. prev_row's contents are dead once this row is emitted (the caller swaps and
+        // zeroes it), so the differences can be built there in place; the simple same-index loop
+        // also lets the compiler vectorize the subtraction.
         for (unsigned int i = 0; i < bytes_per_row; ++i) {
-            ch = static_cast<unsigned char>(cur_row[i] - prev_row[i]);
-            next()->write(&ch, 1);
+            prev_row[i] = static_cast<unsigned char>(cur_row[i] - prev_row[i]);
         }
+        next()->write(prev_row, bytes_per_row);
     } else {
         next()->write(cur_row, bytes_per_row);
     }
@@ -1,8 +1,10 @@
 #include <qpdf/QPDFJob_private.hh>
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <string_view>
 
 #include <qpdf/ClosedFileInputSource.hh>
 #include <qpdf/FileInputSource.hh>
@@ -30,6 +32,15 @@
 
 using namespace qpdf;
 
+namespace
+{
+    bool
+    contains(std::vector<std::string> const& items, std::string_view value)
+    {
+        return std::find(items.begin(), items.end(), value) != items.end();
+    }
+} // namespace
+
 using Pages = impl::Doc::Pages;
 
 namespace
@@ -263,7 +274,7 @@ QPDFJob::QPDFJob() :
 {
 }
 
-void
+[[noreturn]] void
 QPDFJob::usage(std::string const& msg)
 {
     throw QPDFUsage(msg);
@@ -585,8 +596,8 @@ QPDFJob::checkConfiguration()
         usage("--requires-password and --is-encrypted may not be given together");
     }
 
-    if (m->encrypt && !m->allow_insecure && m->owner_password.empty() &&
-        !m->user_password.empty() && m->keylen == 256) {
+    if (m->crypto_action == Members::ca_encrypt && !m->allow_insecure &&
+        m->owner_password.empty() && !m->user_password.empty() && m->keylen == 256) {
         // Note that empty owner passwords for R < 5 are copied from the user password, so this lack
         // of security is not an issue for those files. Also we are consider only the ability to
         // open the file without a password to be insecure. We are not concerned about whether the
@@ -611,18 +622,20 @@ QPDFJob::checkConfiguration()
     if (save_to_stdout) {
         m->log->saveToStandardOutput(true);
     }
-    if (!m->split_pages && QUtil::same_file(m->infile_nm(), m->outfilename.data())) {
+    // Skip the filesystem probe when either name can't refer to a regular file.
+    if (!m->split_pages && !save_to_stdout && !m->infile_name().empty() &&
+        !m->outfilename.empty() && QUtil::same_file(m->infile_nm(), m->outfilename.data())) {
         usage(
             "input file and output file are the same; use --replace-input to intentionally "
             "overwrite the input file");
     }
 
     if (m->json_version == 1) {
-        if (m->json_keys.contains("qpdf")) {
+        if (contains(m->json_keys, "qpdf")) {
             usage("json key \"qpdf\" is only valid for json version > 1");
         }
     } else {
-        if (m->json_keys.contains("objectinfo") || m->json_keys.contains("objects")) {
+        if (contains(m->json_keys, "objectinfo") || contains(m->json_keys, "objects")) {
             usage("json keys \"objects\" and \"objectinfo\" are only valid for json version 1");
         }
     }
@@ -955,7 +968,7 @@ QPDFJob::doJSONObjects(Pipeline* p, bool& first, QPDF& pdf)
                 first_object = false;
             }
         }
-        if (all_objects || m->json_objects.contains("trailer")) {
+        if (all_objects || contains(m->json_objects, "trailer")) {
             JSON::writeDictionaryKey(p, first_object, "trailer", 2);
             pdf.getTrailer().writeJSON(1, p, true, 2);
             first_object = false;
@@ -963,7 +976,7 @@ QPDFJob::doJSONObjects(Pipeline* p, bool& first, QPDF& pdf)
         JSON::writeDictionaryClose(p, first_object, 1);
     } else {
         std::set<std::string> json_objects;
-        if (m->json_objects.contains("trailer")) {
+        if (contains(m->json_objects, "trailer")) {
             json_objects.insert("trailer");
         }
         for (auto og: getWantedJSONObjects()) {
@@ -1320,7 +1333,7 @@ QPDFJob::doJSONAttachments(Pipeline* p, bool& first, QPDF& pdf)
 }
 
 JSON
-QPDFJob::json_schema(int json_version, std::set<std::string>* keys)
+QPDFJob::json_schema(int json_version, std::vector<std::string> const* keys)
 {
     // Style: use all lower-case keys with no dashes or underscores. Choose array or dictionary
     // based on indexing. For example, we use a dictionary for objects because we want to index by
@@ -1505,7 +1518,7 @@ QPDFJob::json_schema(int json_version, std::set<std::string>* keys)
     const bool all_keys = !keys || keys->empty();
 
     auto add_if_want_key = [&](std::string const& key, std::string const& json) -> void {
-        if (all_keys || keys->contains(key)) {
+        if (all_keys || contains(*keys, key)) {
             (void)schema.addDictionaryMember(key, JSON::parse(json));
         }
     };
@@ -1590,7 +1603,7 @@ QPDFJob::doJSON(QPDF& pdf, Pipeline* p)
     const bool all_keys = m->json_keys.empty();
 
     auto want_key = [&](std::string const& key) -> bool {
-        return all_keys || m->json_keys.contains(key);
+        return all_keys || contains(m->json_keys, key);
     };
 
     // The list of selectable top-level keys id duplicated in the following places: job.yml,
@@ -2884,13 +2897,13 @@ QPDFJob::setWriterOptions(Writer& w)
     if (m->compression_level >= 0) {
         Pl_Flate::setCompressionLevel(m->compression_level);
     }
-    if (m->decrypt) {
+    if (m->crypto_action == Members::ca_decrypt) {
         w.setPreserveEncryption(false);
     }
     if (m->static_aes_iv) {
         w.setStaticAesIV(true);
     }
-    if (m->copy_encryption) {
+    if (m->crypto_action == Members::ca_copy) {
         std::unique_ptr<QPDF> encryption_pdf;
         processFile(
             encryption_pdf,
@@ -2900,7 +2913,7 @@ QPDFJob::setWriterOptions(Writer& w)
             false);
         w.copyEncryptionParameters(*encryption_pdf);
     }
-    if (m->encrypt) {
+    if (m->crypto_action == Members::ca_encrypt) {
         setEncryptionOptions(w);
     }
     w.setMinimumPDFVersion(m->max_input_version);
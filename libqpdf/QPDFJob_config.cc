@@ -1,10 +1,62 @@
 #include <qpdf/QPDFJob_private.hh>
 
-#include <regex>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <utility>
 
 #include <qpdf/QPDFLogger.hh>
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
+#include <qpdf/Util.hh>
+
+using namespace qpdf;
+
+namespace
+{
+    // Look parameter up in a small table of (name, value) pairs. The option validators used to be
+    // if/else chains of std::string comparisons; a table keeps the dispatch compact, and checking
+    // the length first rejects most non-matches without a memcmp.
+    template <typename T, size_t N>
+    std::optional<T>
+    match_option(std::string_view parameter, std::pair<std::string_view, T> const (&table)[N])
+    {
+        for (auto const& [name, value]: table) {
+            if (name.size() == parameter.size() && name == parameter) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // The boolean setters take "y" for true and anything else for false. A single-byte check
+    // avoids the std::string/const char* comparison machinery.
+    constexpr bool
+    is_y(std::string_view parameter) noexcept
+    {
+        return parameter.size() == 1 && parameter.front() == 'y';
+    }
+
+    // Convert a decimal option parameter with std::from_chars rather than QUtil::string_to_int,
+    // avoiding the c_str()/strtoll path. Unlike strtoll, this rejects trailing garbage rather
+    // than silently parsing it as 0.
+    template <typename T>
+    T
+    parse_numeric_option(std::string_view parameter, char const* option)
+    {
+        T value{};
+        auto [ptr, ec] =
+            std::from_chars(parameter.data(), parameter.data() + parameter.size(), value);
+        if (ec != std::errc() || ptr != parameter.data() + parameter.size()) {
+            throw QPDFUsage(std::string("invalid numeric value for ") + option);
+        }
+        return value;
+    }
+} // namespace
 
 void
 QPDFJob::Config::checkConfiguration()
@@ -101,16 +153,23 @@ QPDFJob::Config::collate(std::string const& parameter)
         o.m->collate.push_back(1);
         return this;
     }
+    // Parse a,b,c without creating a string for each token.
+    std::string_view sv{parameter};
+    o.m->collate.reserve(1 + static_cast<size_t>(std::count(sv.begin(), sv.end(), ',')));
     size_t pos = 0;
-    // Parse a,b,c
     while (true) {
-        auto end = parameter.find(',', pos);
-        auto n = parameter.substr(pos, end);
+        auto end = sv.find(',', pos);
+        auto n = sv.substr(pos, end == std::string_view::npos ? end : end - pos);
         if (n.empty()) {
             usage("--collate: trailing comma");
         }
-        o.m->collate.push_back(QIntC::to_size(QUtil::string_to_uint(n.c_str())));
-        if (end == std::string::npos) {
+        size_t val{0};
+        auto [ptr, ec] = std::from_chars(n.data(), n.data() + n.size(), val);
+        if (ec != std::errc() || ptr != n.data() + n.size()) {
+            usage("--collate: invalid number");
+        }
+        o.m->collate.push_back(val);
+        if (end == std::string_view::npos) {
             break;
         }
         pos = end + 1;
@@ -124,21 +183,21 @@ QPDFJob::Config::collate(std::string const& parameter)
 QPDFJob::Config*
 QPDFJob::Config::compressStreams(std::string const& parameter)
 {
-    o.m->w_cfg.compress_streams(parameter == "y");
+    o.m->w_cfg.compress_streams(is_y(parameter));
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::compressionLevel(std::string const& parameter)
 {
-    o.m->compression_level = QUtil::string_to_int(parameter.c_str());
+    o.m->compression_level = parse_numeric_option<int>(parameter, "compression-level");
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::jpegQuality(std::string const& parameter)
 {
-    o.m->jpeg_quality = QUtil::string_to_int(parameter.c_str());
+    o.m->jpeg_quality = parse_numeric_option<int>(parameter, "jpeg-quality");
     return this;
 }
 
@@ -149,25 +208,21 @@ QPDFJob::Config::copyEncryption(std::string const& parameter)
         usage("the deterministic-id option is incompatible with encrypted output files");
     }
     o.m->inputs.encryption_file = parameter;
-    o.m->copy_encryption = true;
-    o.m->encrypt = false;
-    o.m->decrypt = false;
+    o.m->crypto_action = Members::ca_copy;
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::decrypt()
 {
-    o.m->decrypt = true;
-    o.m->encrypt = false;
-    o.m->copy_encryption = false;
+    o.m->crypto_action = Members::ca_decrypt;
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::deterministicId()
 {
-    if (o.m->encrypt || o.m->copy_encryption) {
+    if (o.m->crypto_action == Members::ca_encrypt || o.m->crypto_action == Members::ca_copy) {
         usage("the deterministic-id option is incompatible with encrypted output files");
     }
     o.m->w_cfg.deterministic_id(true);
@@ -198,12 +253,17 @@ QPDFJob::Config::filteredStreamData()
 QPDFJob::Config*
 QPDFJob::Config::flattenAnnotations(std::string const& parameter)
 {
+    // The value is a pair of (forbidden, required) annotation flag bits to add.
+    static constexpr std::pair<std::string_view, std::pair<int, int>> modes[] = {
+        {"screen", {an_no_view, 0}},
+        {"print", {0, an_print}},
+        {"all", {0, 0}},
+    };
     o.m->flatten_annotations = true;
-    if (parameter == "screen") {
-        o.m->flatten_annotations_forbidden |= an_no_view;
-    } else if (parameter == "print") {
-        o.m->flatten_annotations_required |= an_print;
-    } else if (parameter != "all") {
+    if (auto mode = match_option(parameter, modes)) {
+        o.m->flatten_annotations_forbidden |= mode->first;
+        o.m->flatten_annotations_required |= mode->second;
+    } else {
         usage("invalid flatten-annotations option");
     }
     return this;
@@ -240,7 +300,7 @@ QPDFJob::Config::ignoreXrefStreams()
 QPDFJob::Config*
 QPDFJob::Config::iiMinBytes(std::string const& parameter)
 {
-    o.m->ii_min_bytes = QUtil::string_to_uint(parameter.c_str());
+    o.m->ii_min_bytes = parse_numeric_option<size_t>(parameter, "ii-min-bytes");
     return this;
 }
 
@@ -261,41 +321,48 @@ QPDFJob::Config::json()
 QPDFJob::Config*
 QPDFJob::Config::json(std::string const& parameter)
 {
-    if (parameter.empty() || (parameter == "latest")) {
-        o.m->json_version = JSON::LATEST;
-    } else {
-        o.m->json_version = QUtil::string_to_int(parameter.c_str());
-    }
-    if ((o.m->json_version < 1) || (o.m->json_version > JSON::LATEST)) {
-        usage(std::string("unsupported json version ") + parameter);
+    int version{JSON::LATEST};
+    if (!(parameter.empty() || parameter == "latest")) {
+        version = parse_numeric_option<int>(parameter, "json");
+        if ((version < 1) || (version > JSON::LATEST)) {
+            usage("unsupported json version " + parameter);
+        }
     }
+    o.m->json_version = version;
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::jsonKey(std::string const& parameter)
 {
-    o.m->json_keys.insert(parameter);
+    if (std::find(o.m->json_keys.begin(), o.m->json_keys.end(), parameter) ==
+        o.m->json_keys.end()) {
+        o.m->json_keys.push_back(parameter);
+    }
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::jsonObject(std::string const& parameter)
 {
-    o.m->json_objects.insert(parameter);
+    if (std::find(o.m->json_objects.begin(), o.m->json_objects.end(), parameter) ==
+        o.m->json_objects.end()) {
+        o.m->json_objects.push_back(parameter);
+    }
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::jsonStreamData(std::string const& parameter)
 {
+    static constexpr std::pair<std::string_view, qpdf_json_stream_data_e> modes[] = {
+        {"none", qpdf_sj_none},
+        {"inline", qpdf_sj_inline},
+        {"file", qpdf_sj_file},
+    };
     o.m->json_stream_data_set = true;
-    if (parameter == "none") {
-        o.m->json_stream_data = qpdf_sj_none;
-    } else if (parameter == "inline") {
-        o.m->json_stream_data = qpdf_sj_inline;
-    } else if (parameter == "file") {
-        o.m->json_stream_data = qpdf_sj_file;
+    if (auto mode = match_option(parameter, modes)) {
+        o.m->json_stream_data = *mode;
     } else {
         usage("invalid json-streams option");
     }
@@ -327,7 +394,10 @@ QPDFJob::Config::jsonOutput(std::string const& parameter)
         o.m->json_stream_data = qpdf_sj_inline;
     }
     o.m->w_cfg.default_decode_level(qpdf_dl_none);
-    o.m->json_keys.insert("qpdf");
+    if (std::find(o.m->json_keys.begin(), o.m->json_keys.end(), "qpdf") ==
+        o.m->json_keys.end()) {
+        o.m->json_keys.emplace_back("qpdf");
+    }
     return this;
 }
 
@@ -349,14 +419,15 @@ QPDFJob::Config*
 QPDFJob::Config::keepFilesOpen(std::string const& parameter)
 {
     o.m->inputs.keep_files_open_set = true;
-    o.m->inputs.keep_files_open = (parameter == "y");
+    o.m->inputs.keep_files_open = is_y(parameter);
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::keepFilesOpenThreshold(std::string const& parameter)
 {
-    o.m->inputs.keep_files_open_threshold = QUtil::string_to_uint(parameter.c_str());
+    o.m->inputs.keep_files_open_threshold =
+        parse_numeric_option<size_t>(parameter, "keep-files-open-threshold");
     return this;
 }
 
@@ -420,28 +491,28 @@ QPDFJob::Config::noWarn()
 QPDFJob::Config*
 QPDFJob::Config::normalizeContent(std::string const& parameter)
 {
-    o.m->w_cfg.normalize_content(parameter == "y");
+    o.m->w_cfg.normalize_content(is_y(parameter));
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::oiMinArea(std::string const& parameter)
 {
-    o.m->oi_min_area = QUtil::string_to_uint(parameter.c_str());
+    o.m->oi_min_area = parse_numeric_option<size_t>(parameter, "oi-min-area");
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::oiMinHeight(std::string const& parameter)
 {
-    o.m->oi_min_height = QUtil::string_to_uint(parameter.c_str());
+    o.m->oi_min_height = parse_numeric_option<size_t>(parameter, "oi-min-height");
     return this;
 }
 
 QPDFJob::Config*
 QPDFJob::Config::oiMinWidth(std::string const& parameter)
 {
-    o.m->oi_min_width = QUtil::string_to_uint(parameter.c_str());
+    o.m->oi_min_width = parse_numeric_option<size_t>(parameter, "oi-min-width");
     return this;
 }
 
@@ -629,7 +700,7 @@ QPDFJob::Config::splitPages()
 QPDFJob::Config*
 QPDFJob::Config::splitPages(std::string const& parameter)
 {
-    int n = (parameter.empty() ? 1 : QUtil::string_to_int(parameter.c_str()));
+    int n = (parameter.empty() ? 1 : parse_numeric_option<int>(parameter, "split-pages"));
     o.m->split_pages = n;
     return this;
 }
@@ -686,18 +757,48 @@ QPDFJob::Config::withImages()
 QPDFJob::Config*
 QPDFJob::Config::passwordFile(std::string const& parameter)
 {
-    std::list<std::string> lines;
+    // Read only the first line rather than materializing every line of the file through
+    // QUtil::read_lines_from_file just to use the front of the list.
+    std::string first_line;
+    bool have_line = false;
+    bool more_lines = false;
+    auto read_first_line = [&](auto&& next_char) {
+        char c;
+        while (next_char(c)) {
+            have_line = true;
+            if (c == '\n') {
+                // As with QUtil::read_lines_from_file, drop a carriage return preceding the
+                // newline. Anything after the newline, even a bare trailing newline, counts as an
+                // additional line.
+                if (!first_line.empty() && first_line.back() == '\r') {
+                    first_line.pop_back();
+                }
+                more_lines = next_char(c);
+                return;
+            }
+            first_line.append(1, c);
+        }
+    };
     if (parameter == "-") {
         QTC::TC("qpdf", "QPDFJob_config password stdin");
-        lines = QUtil::read_lines_from_file(std::cin);
+        read_first_line([](char& ch) { return static_cast<bool>(std::cin.get(ch)); });
     } else {
         QTC::TC("qpdf", "QPDFJob_config password file");
-        lines = QUtil::read_lines_from_file(parameter.c_str());
+        FILE* f = QUtil::safe_fopen(parameter.c_str(), "rb");
+        QUtil::FileCloser fc(f);
+        read_first_line([f](char& ch) {
+            int c = fgetc(f);
+            if (c == EOF) {
+                return false;
+            }
+            ch = static_cast<char>(c);
+            return true;
+        });
     }
-    if (!lines.empty()) {
-        o.m->password = lines.front();
+    if (have_line) {
+        o.m->password = std::move(first_line);
 
-        if (lines.size() > 1) {
+        if (more_lines) {
             *QPDFLogger::defaultLogger()->getError()
                 << o.m->message_prefix << ": WARNING: all but the first line of"
                 << " the password file are ignored\n";
@@ -709,14 +810,14 @@ QPDFJob::Config::passwordFile(std::string const& parameter)
 QPDFJob::Config*
 QPDFJob::Config::passwordMode(std::string const& parameter)
 {
-    if (parameter == "bytes") {
-        o.m->password_mode = QPDFJob::pm_bytes;
-    } else if (parameter == "hex-bytes") {
-        o.m->password_mode = QPDFJob::pm_hex_bytes;
-    } else if (parameter == "unicode") {
-        o.m->password_mode = QPDFJob::pm_unicode;
-    } else if (parameter == "auto") {
-        o.m->password_mode = QPDFJob::pm_auto;
+    static constexpr std::pair<std::string_view, QPDFJob::password_mode_e> modes[] = {
+        {"bytes", QPDFJob::pm_bytes},
+        {"hex-bytes", QPDFJob::pm_hex_bytes},
+        {"unicode", QPDFJob::pm_unicode},
+        {"auto", QPDFJob::pm_auto},
+    };
+    if (auto mode = match_option(parameter, modes)) {
+        o.m->password_mode = *mode;
     } else {
         usage("invalid password-mode option");
     }
@@ -726,12 +827,13 @@ QPDFJob::Config::passwordMode(std::string const& parameter)
 QPDFJob::Config*
 QPDFJob::Config::streamData(std::string const& parameter)
 {
-    if (parameter == "compress") {
-        o.m->w_cfg.stream_data(qpdf_s_compress);
-    } else if (parameter == "preserve") {
-        o.m->w_cfg.stream_data(qpdf_s_preserve);
-    } else if (parameter == "uncompress") {
-        o.m->w_cfg.stream_data(qpdf_s_uncompress);
+    static constexpr std::pair<std::string_view, qpdf_stream_data_e> modes[] = {
+        {"compress", qpdf_s_compress},
+        {"preserve", qpdf_s_preserve},
+        {"uncompress", qpdf_s_uncompress},
+    };
+    if (auto mode = match_option(parameter, modes)) {
+        o.m->w_cfg.stream_data(*mode);
     } else {
         usage("invalid stream-data option");
     }
@@ -741,14 +843,14 @@ QPDFJob::Config::streamData(std::string const& parameter)
 QPDFJob::Config*
 QPDFJob::Config::decodeLevel(std::string const& parameter)
 {
-    if (parameter == "none") {
-        o.m->w_cfg.decode_level(qpdf_dl_none);
-    } else if (parameter == "generalized") {
-        o.m->w_cfg.decode_level(qpdf_dl_generalized);
-    } else if (parameter == "specialized") {
-        o.m->w_cfg.decode_level(qpdf_dl_specialized);
-    } else if (parameter == "all") {
-        o.m->w_cfg.decode_level(qpdf_dl_all);
+    static constexpr std::pair<std::string_view, qpdf_stream_decode_level_e> levels[] = {
+        {"none", qpdf_dl_none},
+        {"generalized", qpdf_dl_generalized},
+        {"specialized", qpdf_dl_specialized},
+        {"all", qpdf_dl_all},
+    };
+    if (auto level = match_option(parameter, levels)) {
+        o.m->w_cfg.decode_level(*level);
     } else {
         usage("invalid option");
     }
@@ -758,12 +860,13 @@ QPDFJob::Config::decodeLevel(std::string const& parameter)
 QPDFJob::Config*
 QPDFJob::Config::objectStreams(std::string const& parameter)
 {
-    if (parameter == "disable") {
-        o.m->w_cfg.object_streams(qpdf_o_disable);
-    } else if (parameter == "preserve") {
-        o.m->w_cfg.object_streams(qpdf_o_preserve);
-    } else if (parameter == "generate") {
-        o.m->w_cfg.object_streams(qpdf_o_generate);
+    static constexpr std::pair<std::string_view, qpdf_object_stream_e> modes[] = {
+        {"disable", qpdf_o_disable},
+        {"preserve", qpdf_o_preserve},
+        {"generate", qpdf_o_generate},
+    };
+    if (auto mode = match_option(parameter, modes)) {
+        o.m->w_cfg.object_streams(*mode);
     } else {
         usage("invalid object stream mode");
     }
@@ -773,12 +876,13 @@ QPDFJob::Config::objectStreams(std::string const& parameter)
 QPDFJob::Config*
 QPDFJob::Config::removeUnreferencedResources(std::string const& parameter)
 {
-    if (parameter == "auto") {
-        o.m->remove_unreferenced_page_resources = QPDFJob::re_auto;
-    } else if (parameter == "yes") {
-        o.m->remove_unreferenced_page_resources = QPDFJob::re_yes;
-    } else if (parameter == "no") {
-        o.m->remove_unreferenced_page_resources = QPDFJob::re_no;
+    static constexpr std::pair<std::string_view, QPDFJob::remove_unref_e> modes[] = {
+        {"auto", QPDFJob::re_auto},
+        {"yes", QPDFJob::re_yes},
+        {"no", QPDFJob::re_no},
+    };
+    if (auto mode = match_option(parameter, modes)) {
+        o.m->remove_unreferenced_page_resources = *mode;
     } else {
         usage("invalid value for --remove-unreferenced-page-resources");
     }
@@ -800,7 +904,7 @@ QPDFJob::Config::jobJsonFile(std::string const& parameter)
         o.initializeFromJson(QUtil::read_file_into_string(parameter.c_str()), true);
     } catch (std::exception& e) {
         throw std::runtime_error(
-            "error with job-json file " + std::string(parameter) + ": " + e.what() + "\nRun " +
+            "error with job-json file " + parameter + ": " + e.what() + "\nRun " +
             o.m->message_prefix + " --job-json-help for information on the file format.");
     }
     return this;
@@ -816,10 +920,10 @@ QPDFJob::Config::rotate(std::string const& parameter)
 std::shared_ptr<QPDFJob::CopyAttConfig>
 QPDFJob::Config::copyAttachmentsFrom()
 {
-    return std::shared_ptr<CopyAttConfig>(new CopyAttConfig(this));
+    return std::make_shared<CopyAttConfig>(config_key(), this);
 }
 
-QPDFJob::CopyAttConfig::CopyAttConfig(Config* c) :
+QPDFJob::CopyAttConfig::CopyAttConfig(config_key, Config* c) :
     config(c)
 {
 }
@@ -851,11 +955,11 @@ QPDFJob::CopyAttConfig::endCopyAttachmentsFrom()
     if (caf.path.empty()) {
         usage("copy attachments: no file specified");
     }
-    config->o.m->attachments_to_copy.push_back(caf);
+    config->o.m->attachments_to_copy.push_back(std::move(caf));
     return config;
 }
 
-QPDFJob::AttConfig::AttConfig(Config* c) :
+QPDFJob::AttConfig::AttConfig(config_key, Config* c) :
     config(c)
 {
 }
@@ -863,7 +967,7 @@ QPDFJob::AttConfig::AttConfig(Config* c) :
 std::shared_ptr<QPDFJob::AttConfig>
 QPDFJob::Config::addAttachment()
 {
-    return std::shared_ptr<AttConfig>(new AttConfig(this));
+    return std::make_shared<AttConfig>(config_key(), this);
 }
 
 QPDFJob::AttConfig*
@@ -891,7 +995,7 @@ QPDFJob::AttConfig*
 QPDFJob::AttConfig::creationdate(std::string const& parameter)
 {
     if (!QUtil::pdf_time_to_qpdf_time(parameter)) {
-        usage(std::string(parameter) + " is not a valid PDF timestamp");
+        usage(parameter + " is not a valid PDF timestamp");
     }
     att.creationdate = parameter;
     return this;
@@ -901,7 +1005,7 @@ QPDFJob::AttConfig*
 QPDFJob::AttConfig::moddate(std::string const& parameter)
 {
     if (!QUtil::pdf_time_to_qpdf_time(parameter)) {
-        usage(std::string(parameter) + " is not a valid PDF timestamp");
+        usage(parameter + " is not a valid PDF timestamp");
     }
     att.moddate = parameter;
     return this;
@@ -910,7 +1014,7 @@ QPDFJob::AttConfig::moddate(std::string const& parameter)
 QPDFJob::AttConfig*
 QPDFJob::AttConfig::mimetype(std::string const& parameter)
 {
-    if (parameter.find('/') == std::string::npos) {
+    if (std::memchr(parameter.data(), '/', parameter.size()) == nullptr) {
         usage("mime type should be specified as type/subtype");
     }
     att.mimetype = parameter;
@@ -934,7 +1038,12 @@ QPDFJob::AttConfig::replace()
 QPDFJob::Config*
 QPDFJob::AttConfig::endAddAttachment()
 {
-    static std::string now = QUtil::qpdf_time_to_pdf_time(QUtil::get_current_qpdf_time());
+    // Cache the timestamp in the job rather than in a function-local static so that repeated
+    // calls don't go through the thread-safe initialization guard.
+    std::string& now = config->o.m->attachment_now_pdf_time;
+    if (now.empty()) {
+        now = QUtil::qpdf_time_to_pdf_time(QUtil::get_current_qpdf_time());
+    }
     if (att.path.empty()) {
         usage("add attachment: no file specified");
     }
@@ -955,11 +1064,11 @@ QPDFJob::AttConfig::endAddAttachment()
         att.moddate = now;
     }
 
-    config->o.m->attachments_to_add.push_back(att);
+    config->o.m->attachments_to_add.push_back(std::move(att));
     return config;
 }
 
-QPDFJob::PagesConfig::PagesConfig(Config* c) :
+QPDFJob::PagesConfig::PagesConfig(config_key, Config* c) :
     config(c)
 {
 }
@@ -970,7 +1079,7 @@ QPDFJob::Config::pages()
     if (!o.m->inputs.selections.empty()) {
         usage("--pages may only be specified one time");
     }
-    return std::shared_ptr<PagesConfig>(new PagesConfig(this));
+    return std::make_shared<PagesConfig>(config_key(), this);
 }
 
 QPDFJob::Config*
@@ -1027,7 +1136,7 @@ QPDFJob::Config::overlay()
 {
     o.m->overlay.emplace_back("overlay");
     o.m->under_overlay = &o.m->overlay.back();
-    return std::shared_ptr<UOConfig>(new UOConfig(this));
+    return std::make_shared<UOConfig>(config_key(), this);
 }
 
 std::shared_ptr<QPDFJob::UOConfig>
@@ -1035,10 +1144,10 @@ QPDFJob::Config::underlay()
 {
     o.m->underlay.emplace_back("underlay");
     o.m->under_overlay = &o.m->underlay.back();
-    return std::shared_ptr<UOConfig>(new UOConfig(this));
+    return std::make_shared<UOConfig>(config_key(), this);
 }
 
-QPDFJob::UOConfig::UOConfig(Config* c) :
+QPDFJob::UOConfig::UOConfig(config_key, Config* c) :
     config(c)
 {
 }
@@ -1112,55 +1221,117 @@ QPDFJob::Config::encrypt(
     }
     o.m->user_password = user_password;
     o.m->owner_password = owner_password;
-    return std::shared_ptr<EncConfig>(new EncConfig(this));
-}
-
-QPDFJob::Config*
-QPDFJob::Config::setPageLabels(const std::vector<std::string>& specs)
-{
-    static std::regex page_label_re(R"(^(z|r?\d+):([DaArR])?(?:/(\d+)?(?:/(.+)?)?)?$)");
-    o.m->page_label_specs.clear();
-    for (auto const& spec: specs) {
-        std::smatch match;
-        if (!std::regex_match(spec, match, page_label_re)) {
-            usage("page label spec must be n:[D|a|A|r|R][/start[/prefix]]");
-        }
-        auto first_page_str = match[1].str();
-        int first_page;
-        if (first_page_str == "z") {
+    return std::make_shared<EncConfig>(config_key(), this);
+}
+
+namespace
+{
+    // Parse a page label spec of the form n:[D|a|A|r|R][/start[/prefix]] in a single pass. This
+    // is equivalent to matching against ^(z|r?\d+):([DaArR])?(?:/(\d+)?(?:/(.+)?)?)?$ but avoids
+    // the cost of std::regex and the per-call std::smatch allocations. Returns false if the spec
+    // is not well-formed.
+    bool
+    parse_page_label_spec(
+        std::string const& spec,
+        int& first_page,
+        qpdf_page_label_e& label_type,
+        int& start_num,
+        std::string& prefix)
+    {
+        char const* p = spec.data();
+        char const* const end = p + spec.size();
+        if (p != end && *p == 'z') {
             first_page = -1;
-        } else if (first_page_str.at(0) == 'r') {
-            first_page = -QUtil::string_to_int(first_page_str.substr(1).c_str());
+            ++p;
         } else {
-            first_page = QUtil::string_to_int(first_page_str.c_str());
+            bool relative = (p != end && *p == 'r');
+            if (relative) {
+                ++p;
+            }
+            if (p == end || !util::is_digit(*p)) {
+                return false;
+            }
+            auto [ptr, ec] = std::from_chars(p, end, first_page);
+            if (ec != std::errc()) {
+                return false;
+            }
+            p = ptr;
+            if (relative) {
+                first_page = -first_page;
+            }
+        }
+        if (p == end || *p != ':') {
+            return false;
         }
-        auto label_type_ch = match[2].matched ? match[2].str().at(0) : '\0';
-        qpdf_page_label_e label_type;
-        switch (label_type_ch) {
+        ++p;
+        switch (p != end ? *p : '\0') {
         case 'D':
             label_type = pl_digits;
+            ++p;
             break;
         case 'a':
             label_type = pl_alpha_lower;
+            ++p;
             break;
         case 'A':
             label_type = pl_alpha_upper;
+            ++p;
             break;
         case 'r':
             label_type = pl_roman_lower;
+            ++p;
             break;
         case 'R':
             label_type = pl_roman_upper;
+            ++p;
             break;
         default:
             label_type = pl_none;
         }
+        start_num = 1;
+        prefix.clear();
+        if (p == end) {
+            return true;
+        }
+        if (*p != '/') {
+            return false;
+        }
+        ++p;
+        if (p != end && util::is_digit(*p)) {
+            auto [ptr, ec] = std::from_chars(p, end, start_num);
+            if (ec != std::errc()) {
+                return false;
+            }
+            p = ptr;
+        }
+        if (p == end) {
+            return true;
+        }
+        if (*p != '/') {
+            return false;
+        }
+        ++p;
+        prefix.assign(p, end);
+        return true;
+    }
+} // namespace
 
-        auto start_num = match[3].matched ? QUtil::string_to_int(match[3].str().c_str()) : 1;
+QPDFJob::Config*
+QPDFJob::Config::setPageLabels(const std::vector<std::string>& specs)
+{
+    o.m->page_label_specs.clear();
+    o.m->page_label_specs.reserve(specs.size());
+    for (auto const& spec: specs) {
+        int first_page{0};
+        qpdf_page_label_e label_type{pl_none};
+        int start_num{1};
+        std::string prefix;
+        if (!parse_page_label_spec(spec, first_page, label_type, start_num, prefix)) {
+            usage("page label spec must be n:[D|a|A|r|R][/start[/prefix]]");
+        }
         if (start_num < 1) {
             usage("starting page number must be >= 1");
         }
-        auto prefix = match[4].matched ? match[4].str() : "";
         // We can't check ordering until we know how many pages there are, so that is delayed until
         // near the end.
         o.m->page_label_specs.emplace_back(first_page, label_type, start_num, prefix);
@@ -1168,7 +1339,7 @@ QPDFJob::Config::setPageLabels(const std::vector<std::string>& specs)
     return this;
 }
 
-QPDFJob::EncConfig::EncConfig(Config* c) :
+QPDFJob::EncConfig::EncConfig(config_key, Config* c) :
     config(c)
 {
 }
@@ -1179,9 +1350,7 @@ QPDFJob::EncConfig::endEncrypt()
     if (config->o.m->keylen == 0) {
         usage("encryption key length is required");
     }
-    config->o.m->encrypt = true;
-    config->o.m->decrypt = false;
-    config->o.m->copy_encryption = false;
+    config->o.m->crypto_action = Members::ca_encrypt;
     return config;
 }
 
@@ -1195,7 +1364,7 @@ QPDFJob::EncConfig::allowInsecure()
 QPDFJob::EncConfig*
 QPDFJob::EncConfig::accessibility(std::string const& parameter)
 {
-    config->o.m->r3_accessibility = (parameter == "y");
+    config->o.m->r3_accessibility = is_y(parameter);
     return this;
 }
 
@@ -1203,9 +1372,9 @@ QPDFJob::EncConfig*
 QPDFJob::EncConfig::extract(std::string const& parameter)
 {
     if (config->o.m->keylen == 40) {
-        config->o.m->r2_extract = (parameter == "y");
+        config->o.m->r2_extract = is_y(parameter);
     } else {
-        config->o.m->r3_extract = (parameter == "y");
+        config->o.m->r3_extract = is_y(parameter);
     }
     return this;
 }
@@ -1213,14 +1382,15 @@ QPDFJob::EncConfig::extract(std::string const& parameter)
 QPDFJob::EncConfig*
 QPDFJob::EncConfig::print(std::string const& parameter)
 {
+    static constexpr std::pair<std::string_view, qpdf_r3_print_e> modes[] = {
+        {"full", qpdf_r3p_full},
+        {"low", qpdf_r3p_low},
+        {"none", qpdf_r3p_none},
+    };
     if (config->o.m->keylen == 40) {
-        config->o.m->r2_print = (parameter == "y");
-    } else if (parameter == "full") {
-        config->o.m->r3_print = qpdf_r3p_full;
-    } else if (parameter == "low") {
-        config->o.m->r3_print = qpdf_r3p_low;
-    } else if (parameter == "none") {
-        config->o.m->r3_print = qpdf_r3p_none;
+        config->o.m->r2_print = is_y(parameter);
+    } else if (auto mode = match_option(parameter, modes)) {
+        config->o.m->r3_print = *mode;
     } else {
         usage("invalid print option");
     }
@@ -1230,33 +1400,28 @@ QPDFJob::EncConfig::print(std::string const& parameter)
 QPDFJob::EncConfig*
 QPDFJob::EncConfig::modify(std::string const& parameter)
 {
+    // The value is (assemble, annotate_and_form, form_filling, modify_other).
+    struct r3_modify
+    {
+        bool assemble;
+        bool annotate_and_form;
+        bool form_filling;
+        bool modify_other;
+    };
+    static constexpr std::pair<std::string_view, r3_modify> modes[] = {
+        {"all", {true, true, true, true}},
+        {"annotate", {true, true, true, false}},
+        {"form", {true, false, true, false}},
+        {"assembly", {true, false, false, false}},
+        {"none", {false, false, false, false}},
+    };
     if (config->o.m->keylen == 40) {
-        config->o.m->r2_modify = (parameter == "y");
-    } else if (parameter == "all") {
-        config->o.m->r3_assemble = true;
-        config->o.m->r3_annotate_and_form = true;
-        config->o.m->r3_form_filling = true;
-        config->o.m->r3_modify_other = true;
-    } else if (parameter == "annotate") {
-        config->o.m->r3_assemble = true;
-        config->o.m->r3_annotate_and_form = true;
-        config->o.m->r3_form_filling = true;
-        config->o.m->r3_modify_other = false;
-    } else if (parameter == "form") {
-        config->o.m->r3_assemble = true;
-        config->o.m->r3_annotate_and_form = false;
-        config->o.m->r3_form_filling = true;
-        config->o.m->r3_modify_other = false;
-    } else if (parameter == "assembly") {
-        config->o.m->r3_assemble = true;
-        config->o.m->r3_annotate_and_form = false;
-        config->o.m->r3_form_filling = false;
-        config->o.m->r3_modify_other = false;
-    } else if (parameter == "none") {
-        config->o.m->r3_assemble = false;
-        config->o.m->r3_annotate_and_form = false;
-        config->o.m->r3_form_filling = false;
-        config->o.m->r3_modify_other = false;
+        config->o.m->r2_modify = is_y(parameter);
+    } else if (auto mode = match_option(parameter, modes)) {
+        config->o.m->r3_assemble = mode->assemble;
+        config->o.m->r3_annotate_and_form = mode->annotate_and_form;
+        config->o.m->r3_form_filling = mode->form_filling;
+        config->o.m->r3_modify_other = mode->modify_other;
     } else {
         usage("invalid modify option");
     }
@@ -1273,7 +1438,7 @@ QPDFJob::EncConfig::cleartextMetadata()
 QPDFJob::EncConfig*
 QPDFJob::EncConfig::assemble(std::string const& parameter)
 {
-    config->o.m->r3_assemble = (parameter == "y");
+    config->o.m->r3_assemble = is_y(parameter);
     return this;
 }
 
@@ -1281,9 +1446,9 @@ QPDFJob::EncConfig*
 QPDFJob::EncConfig::annotate(std::string const& parameter)
 {
     if (config->o.m->keylen == 40) {
-        config->o.m->r2_annotate = (parameter == "y");
+        config->o.m->r2_annotate = is_y(parameter);
     } else {
-        config->o.m->r3_annotate_and_form = (parameter == "y");
+        config->o.m->r3_annotate_and_form = is_y(parameter);
     }
     return this;
 }
@@ -1291,21 +1456,21 @@ QPDFJob::EncConfig::annotate(std::string const& parameter)
 QPDFJob::EncConfig*
 QPDFJob::EncConfig::form(std::string const& parameter)
 {
-    config->o.m->r3_form_filling = (parameter == "y");
+    config->o.m->r3_form_filling = is_y(parameter);
     return this;
 }
 
 QPDFJob::EncConfig*
 QPDFJob::EncConfig::modifyOther(std::string const& parameter)
 {
-    config->o.m->r3_modify_other = (parameter == "y");
+    config->o.m->r3_modify_other = is_y(parameter);
     return this;
 }
 
 QPDFJob::EncConfig*
 QPDFJob::EncConfig::useAes(std::string const& parameter)
 {
-    config->o.m->use_aes = (parameter == "y");
+    config->o.m->use_aes = is_y(parameter);
     return this;
 }
 
@@ -10,7 +10,14 @@
 #include <sstream>
 #include <stdexcept>
 
-static JSON JOB_SCHEMA = JSON::parse(QPDFJob::job_json_schema(1).c_str());
+// Parse the schema lazily so that the cost is paid by the first job-json user rather than at
+// library load time.
+static JSON const&
+job_schema()
+{
+    static JSON schema = JSON::parse(QPDFJob::job_json_schema(1).c_str());
+    return schema;
+}
 
 namespace
 {
@@ -626,7 +633,7 @@ QPDFJob::initializeFromJson(std::string const& json, bool partial)
 {
     std::list<std::string> errors;
     JSON j = JSON::parse(json);
-    if (!j.checkSchema(JOB_SCHEMA, JSON::f_optional, errors)) {
+    if (!j.checkSchema(job_schema(), JSON::f_optional, errors)) {
         std::ostringstream msg;
         msg << m->message_prefix << ": job json has errors:";
         for (auto const& error: errors) {
@@ -19,8 +19,13 @@
 #include <qpdf/Util.hh>
 
 #include <algorithm>
+#include <bit>
+#include <charconv>
 #include <concepts>
+#include <limits>
+#include <array>
 #include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 #include <tuple>
 
@@ -54,6 +59,54 @@ QPDFWriter::FunctionProgressReporter::reportProgress(int progress)
 
 namespace
 {
+    // Collect the many small tokens the writer emits into a fixed-size buffer and forward them to
+    // the output file in large chunks. Writing them individually would pay for a locked fwrite
+    // call per token.
+    class Pl_buffered final: public Pipeline
+    {
+      public:
+        Pl_buffered(Pipeline* next) :
+            Pipeline("qpdf buffered output", next)
+        {
+            buf.reserve(buf_limit);
+        }
+        ~Pl_buffered() final = default;
+
+        void
+        write(unsigned char const* data, size_t len) final
+        {
+            if (len >= buf_limit) {
+                flush();
+                next()->write(data, len);
+                return;
+            }
+            if (buf.size() + len > buf_limit) {
+                flush();
+            }
+            buf.append(reinterpret_cast<char const*>(data), len);
+        }
+
+        void
+        finish() final
+        {
+            flush();
+            next()->finish();
+        }
+
+      private:
+        void
+        flush()
+        {
+            if (!buf.empty()) {
+                next()->write(reinterpret_cast<unsigned char const*>(buf.data()), buf.size());
+                buf.clear();
+            }
+        }
+
+        static size_t constexpr buf_limit = 64 * 1024;
+        std::string buf;
+    };
+
     class Pl_stack
     {
         // A pipeline Popper is normally returned by Pl_stack::activate, or, if necessary, a
@@ -112,6 +165,9 @@ namespace
         Pl_stack(pl::Count*& top) :
             top(top)
         {
+            // count_buffer is cleared and reused for every pipeline-backed activation; give it
+            // capacity up front so early streams don't grow it incrementally.
+            count_buffer.reserve(4096);
         }
 
         Popper
@@ -330,7 +386,12 @@ namespace qpdf::impl
         void enqueueObjectsPCLm();
         void enqueuePart(std::vector<QPDFObjectHandle>& part);
         void assignCompressedObjectNumbers(QPDFObjGen og);
-        Dictionary trimmed_trailer();
+        bool
+        is_object_stream(int id) const
+        {
+            auto idx = static_cast<size_t>(id);
+            return idx < object_stream_to_objects.size() && !object_stream_to_objects[idx].empty();
+        }
 
         // Returns tuple<filter, compress_stream, is_root_metadata>
         std::tuple<const bool, const bool, const bool>
@@ -339,7 +400,6 @@ namespace qpdf::impl
         // Test whether stream would be filtered if it were written.
         bool will_filter_stream(QPDFObjectHandle stream);
         unsigned int bytesNeeded(long long n);
-        void writeBinary(unsigned long long val, unsigned int bytes);
         Writer& write(std::string_view str);
         Writer& write(size_t count, char c);
         Writer& write(std::integral auto val);
@@ -425,6 +485,9 @@ namespace qpdf::impl
         qpdf::Writer::Config cfg;
 
         QPDFObjGen root_og{-1, 0};
+        // Root dictionary with /Extensions adjusted for output, built the first time the root is
+        // written and reused if it is written again (linearization writes it in both passes).
+        QPDFObjectHandle prepared_root;
         char const* filename{"unspecified"};
         FILE* file{nullptr};
         bool close_file{false};
@@ -439,12 +502,21 @@ namespace qpdf::impl
         std::string final_pdf_version;
         int final_extension_level{0};
         std::string min_pdf_version;
+        // Parsed form of min_pdf_version, kept in sync so comparisons don't re-parse it.
+        int min_major{0};
+        int min_minor{0};
         int min_extension_level{0};
         int encryption_dict_objid{0};
         std::string cur_data_key;
+        // Per-object data keys derived during linearization pass 1, reused in pass 2.
+        std::vector<std::string> data_key_cache;
         std::unique_ptr<Pipeline> file_pl;
+        // Buffers output between the pipeline stack and file_pl.
+        std::unique_ptr<Pipeline> buffered_pl;
         qpdf::pl::Count* pipeline{nullptr};
-        std::vector<QPDFObjectHandle> object_queue;
+        // Queue of objects to write, in order. Stored as object ids rather than handles to keep
+        // the queue compact; the handle is re-fetched at write time.
+        std::vector<QPDFObjGen> object_queue;
         size_t object_queue_front{0};
         QPDFWriter::ObjTable obj;
         QPDFWriter::NewObjTable new_obj;
@@ -453,10 +525,21 @@ namespace qpdf::impl
         size_t cur_stream_length{0};
         bool added_newline{false};
         size_t max_ostream_index{0};
-        std::set<QPDFObjGen> normalized_streams;
-        std::map<QPDFObjGen, int> page_object_to_seq;
-        std::map<QPDFObjGen, int> contents_to_page_seq;
-        std::map<int, std::vector<QPDFObjGen>> object_stream_to_objects;
+        // QDF / content-normalization bookkeeping, indexed by original object id. A zero
+        // sequence number means the object is not a page or page content stream.
+        struct SpecialStream
+        {
+            int page_seq{0};
+            int contents_page_seq{0};
+        };
+        ObjTable<SpecialStream> special_streams;
+        // Members of each object stream, indexed by original object stream id. Entries for
+        // objects that are not object streams are empty.
+        std::vector<std::vector<QPDFObjGen>> object_stream_to_objects;
+        // Scratch buffers for writeObjectStream, reused across object streams.
+        std::string stream_buffer_pass1;
+        std::string stream_buffer_pass2;
+        bool have_object_streams{false};
         Pl_stack pipeline_stack;
         std::string deterministic_id_data;
         bool did_write_setup{false};
@@ -466,6 +549,7 @@ namespace qpdf::impl
         int events_expected{0};
         int events_seen{0};
         int next_progress_report{0};
+        int progress_increment{1};
     }; // class qpdf::impl::Writer
 
 } // namespace qpdf::impl
@@ -528,7 +612,8 @@ QPDFWriter::setOutputFile(char const* description, FILE* file, bool close_file)
     m->file = file;
     m->close_file = close_file;
     m->file_pl = std::make_unique<Pl_StdioFile>("qpdf output", file);
-    m->pipeline_stack.initialize(m->file_pl.get());
+    m->buffered_pl = std::make_unique<Pl_buffered>(m->file_pl.get());
+    m->pipeline_stack.initialize(m->buffered_pl.get());
 }
 
 void
@@ -699,17 +784,14 @@ impl::Writer::setMinimumPDFVersion(std::string const& version, int extension_lev
 {
     bool set_version = false;
     bool set_extension_level = false;
+    int new_major = 0;
+    int new_minor = 0;
+    parseVersion(version, new_major, new_minor);
     if (min_pdf_version.empty()) {
         set_version = true;
         set_extension_level = true;
     } else {
-        int old_major = 0;
-        int old_minor = 0;
-        int min_major = 0;
-        int min_minor = 0;
-        parseVersion(version, old_major, old_minor);
-        parseVersion(min_pdf_version, min_major, min_minor);
-        int compare = compareVersions(old_major, old_minor, min_major, min_minor);
+        int compare = compareVersions(new_major, new_minor, min_major, min_minor);
         if (compare > 0) {
             QTC::TC("qpdf", "QPDFWriter increasing minimum version", extension_level == 0 ? 0 : 1);
             set_version = true;
@@ -723,6 +805,8 @@ impl::Writer::setMinimumPDFVersion(std::string const& version, int extension_lev
 
     if (set_version) {
         min_pdf_version = version;
+        min_major = new_major;
+        min_minor = new_minor;
     }
     if (set_extension_level) {
         min_extension_level = extension_level;
@@ -1191,16 +1275,8 @@ impl::Writer::parseVersion(std::string const& version, int& major, int& minor) c
 int
 impl::Writer::compareVersions(int major1, int minor1, int major2, int minor2) const
 {
-    if (major1 < major2) {
-        return -1;
-    }
-    if (major1 > major2) {
-        return 1;
-    }
-    if (minor1 < minor2) {
-        return -1;
-    }
-    return minor1 > minor2 ? 1 : 0;
+    int d = major1 != major2 ? major1 - major2 : minor1 - minor2;
+    return (d > 0) - (d < 0);
 }
 
 void
@@ -1223,40 +1299,40 @@ impl::Writer::setEncryptionMinimumVersion()
 void
 impl::Writer::setDataKey(int objid)
 {
-    if (encryption) {
-        cur_data_key = QPDF::compute_data_key(
-            encryption_key,
-            objid,
-            0,
-            cfg.encrypt_use_aes(),
-            encryption->getV(),
-            encryption->getR());
+    if (!encryption) {
+        return;
+    }
+    if (cfg.linearize() && encryption->getV() < 5) {
+        // Linearization writes every object twice, and for V < 5 each derivation runs an MD5
+        // over the key material. Remember the key from the first pass. Newly written objects
+        // always have generation 0, so the object id alone identifies the key.
+        auto idx = static_cast<size_t>(objid);
+        if (idx >= data_key_cache.size()) {
+            data_key_cache.resize(std::max(idx + 1, new_obj.size()));
+        }
+        auto& key = data_key_cache[idx];
+        if (key.empty()) {
+            key = QPDF::compute_data_key(
+                encryption_key,
+                objid,
+                0,
+                cfg.encrypt_use_aes(),
+                encryption->getV(),
+                encryption->getR());
+        }
+        cur_data_key = key;
+        return;
     }
+    cur_data_key = QPDF::compute_data_key(
+        encryption_key, objid, 0, cfg.encrypt_use_aes(), encryption->getV(), encryption->getR());
 }
 
 unsigned int
 impl::Writer::bytesNeeded(long long n)
 {
-    unsigned int bytes = 0;
-    while (n) {
-        ++bytes;
-        n >>= 8;
-    }
-    return bytes;
-}
-
-void
-impl::Writer::writeBinary(unsigned long long val, unsigned int bytes)
-{
-    if (bytes > sizeof(unsigned long long)) {
-        throw std::logic_error("QPDFWriter::writeBinary called with too many bytes");
-    }
-    unsigned char data[sizeof(unsigned long long)];
-    for (unsigned int i = 0; i < bytes; ++i) {
-        data[bytes - i - 1] = static_cast<unsigned char>(val & 0xff);
-        val >>= 8;
-    }
-    pipeline->write(data, bytes);
+    // bit_width(0) is 0, preserving the historical zero-byte result for n == 0.
+    auto bits = static_cast<unsigned int>(std::bit_width(static_cast<unsigned long long>(n)));
+    return (bits + 7) / 8;
 }
 
 impl::Writer&
@@ -1269,7 +1345,11 @@ impl::Writer::write(std::string_view str)
 impl::Writer&
 impl::Writer::write(std::integral auto val)
 {
-    pipeline->write(std::to_string(val));
+    // Format into a stack buffer; to_string would construct a std::string per integer on what is
+    // the most frequently used write overload.
+    char buf[std::numeric_limits<decltype(val)>::digits10 + 3];
+    auto* end = std::to_chars(buf, buf + sizeof(buf), val).ptr;
+    pipeline->write(std::string_view(buf, static_cast<size_t>(end - buf)));
     return *this;
 }
 
@@ -1290,7 +1370,7 @@ impl::Writer::write_name(std::string const& str)
 impl::Writer&
 impl::Writer::write_string(std::string const& str, bool force_binary)
 {
-    pipeline->write(QPDF_String(str).unparse(force_binary));
+    pipeline->write(QPDF_String::unparse(str, force_binary));
     return *this;
 }
 
@@ -1374,13 +1454,13 @@ void
 impl::Writer::assignCompressedObjectNumbers(QPDFObjGen og)
 {
     int objid = og.getObj();
-    if (og.getGen() != 0 || !object_stream_to_objects.contains(objid)) {
+    if (og.getGen() != 0 || !is_object_stream(objid)) {
         // This is not an object stream.
         return;
     }
 
     // Reserve numbers for the objects that belong to this object stream.
-    for (auto const& iter: object_stream_to_objects[objid]) {
+    for (auto const& iter: object_stream_to_objects[static_cast<size_t>(objid)]) {
         obj[iter].renumber = next_objid++;
     }
 }
@@ -1420,10 +1500,10 @@ impl::Writer::enqueue(QPDFObjectHandle const& object)
                 o.renumber = -1;
                 enqueue(qpdf.getObject(o.object_stream, 0));
             } else {
-                object_queue.emplace_back(object);
+                object_queue.emplace_back(og);
                 o.renumber = next_objid++;
 
-                if (og.getGen() == 0 && object_stream_to_objects.contains(og.getObj())) {
+                if (og.getGen() == 0 && is_object_stream(og.getObj())) {
                     // For linearized files, uncompressed objects go at end, and we take care of
                     // assigning numbers to them elsewhere.
                     if (!cfg.linearize()) {
@@ -1469,11 +1549,32 @@ impl::Writer::unparseChild(QPDFObjectHandle const& child, size_t level, int flag
     }
 }
 
+// Trailer keys that necessarily have to be replaced when writing the file: encryption keys,
+// modification information, and keys that potentially come from a cross-reference stream.
+static bool
+is_trimmed_trailer_key(std::string_view key)
+{
+    static constexpr std::array<std::string_view, 10> trimmed{
+        "/ID",
+        "/Encrypt",
+        "/Prev",
+        "/Index",
+        "/W",
+        "/Length",
+        "/Filter",
+        "/DecodeParms",
+        "/Type",
+        "/XRefStm"};
+    return std::find(trimmed.begin(), trimmed.end(), key) != trimmed.end();
+}
+
 void
 impl::Writer::writeTrailer(
     trailer_e which, int size, bool xref_stream, qpdf_offset_t prev, int linearization_pass)
 {
-    auto trailer = trimmed_trailer();
+    // Iterate the real trailer and skip the trimmed keys rather than materializing a trimmed
+    // shallow copy per call.
+    Dictionary trailer = qpdf.getTrailer();
     if (xref_stream) {
         cur_data_key.clear();
     } else {
@@ -1484,7 +1585,7 @@ impl::Writer::writeTrailer(
         write(" /Size ").write(size);
     } else {
         for (auto const& [key, value]: trailer) {
-            if (value.null()) {
+            if (value.null() || is_trimmed_trailer_key(key)) {
                 continue;
             }
             write_qdf("  ").write_no_qdf(" ").write_name(key).write(" ");
@@ -1513,7 +1614,7 @@ impl::Writer::writeTrailer(
             // While writing the original ID would have the same number of bytes, it would cause a
             // change to the deterministic ID generated by older versions of the software that
             // hard-coded the length of the ID to 16 bytes.
-            size_t len = QPDF_String(original_id1).unparse(true).length() - 2;
+            size_t len = QPDF_String::unparse(original_id1, true).length() - 2;
             write("<").write(len, '0').write(">");
         }
         write("<00000000000000000000000000000000>");
@@ -1539,8 +1640,7 @@ impl::Writer::writeTrailer(
 bool
 impl::Writer::will_filter_stream(QPDFObjectHandle stream)
 {
-    std::string s;
-    [[maybe_unused]] auto [filter, ignore1, ignore2] = will_filter_stream(stream, &s);
+    [[maybe_unused]] auto [filter, ignore1, ignore2] = will_filter_stream(stream, nullptr);
     return filter;
 }
 
@@ -1569,20 +1669,34 @@ impl::Writer::will_filter_stream(QPDFObjectHandle stream, std::string* stream_da
         if (is_root_metadata && (!encryption || !encryption->getEncryptMetadata())) {
             filter = true;
             decode_level = qpdf_dl_all;
-        } else if (cfg.normalize_content() && normalized_streams.contains(stream)) {
+        } else if (cfg.normalize_content() && special_streams[stream].contents_page_seq) {
             encode_flags = qpdf_ef_normalize;
             filter = true;
-        } else if (filter && cfg.compress_streams()) {
+        } else if (filter && cfg.compress_streams() && stream_data) {
+            // Without a stream_data destination this is only a filterability probe, and whether
+            // the decoded data gets re-deflated cannot change the outcome, so skip the
+            // compression and write the decoded bytes to the discard pipeline.
             encode_flags = qpdf_ef_compress;
         }
     }
 
     // Disable compression for empty streams to improve compatibility
-    if (Integer(stream_dict["/Length"]) == 0) {
+    Integer declared_length = stream_dict["/Length"];
+    if (declared_length == 0) {
         filter = true;
         encode_flags = 0;
     }
 
+    if (stream_data && declared_length) {
+        // The declared length is a reasonable guess at the output size, and reserving up front
+        // also keeps the capacity across the clear() when we retry unfiltered. /Length can be
+        // damaged, so don't trust absurd values.
+        auto hint = declared_length.value();
+        if (hint > 0 && hint <= (1 << 24)) {
+            stream_data->reserve(static_cast<size_t>(hint));
+        }
+    }
+
     for (bool first_attempt: {true, false}) {
         auto pp_stream_data =
             stream_data ? pipeline_stack.activate(*stream_data) : pipeline_stack.activate(true);
@@ -1624,11 +1738,21 @@ impl::Writer::unparseObject(
     QPDFObjGen old_og = object.getObjGen();
     int child_flags = flags & ~f_stream;
     // For non-qdf, "indent" and "indent_large" are a single space between tokens. For qdf, they
-    // include the preceding newline.
-    std::string indent_large = " ";
+    // include the preceding newline. Common nesting depths are served as views into a static
+    // buffer to avoid building an indent string for every node visited.
+    static constexpr std::string_view qdf_indent{
+        "\n                                                                "}; // 32 levels
+    std::string deep_indent;
+    std::string_view indent_large{" "};
     if (cfg.qdf()) {
-        indent_large.append(2 * (level + 1), ' ');
-        indent_large[0] = '\n';
+        size_t len = 2 * (level + 1) + 1;
+        if (len <= qdf_indent.size()) {
+            indent_large = qdf_indent.substr(0, len);
+        } else {
+            deep_indent.assign(len, ' ');
+            deep_indent[0] = '\n';
+            indent_large = deep_indent;
+        }
     }
     std::string_view indent{indent_large.data(), cfg.qdf() ? indent_large.size() - 2 : 1};
 
@@ -1645,7 +1769,11 @@ impl::Writer::unparseObject(
     } else if (tc == ::ot_dictionary) {
         // Handle special cases for specific dictionaries.
 
-        if (old_og == root_og) {
+        if (old_og == root_og && prepared_root) {
+            // The root was already written once this run; reuse the prepared copy rather than
+            // redoing the /Extensions analysis.
+            object = prepared_root;
+        } else if (old_og == root_og) {
             // Extensions dictionaries.
 
             // We have one of several cases:
@@ -1719,6 +1847,7 @@ impl::Writer::unparseObject(
                     }
                 }
             }
+            prepared_root = object;
         }
 
         // Stream dictionaries.
@@ -1833,24 +1962,14 @@ impl::Writer::unparseObject(
             !cur_data_key.empty()) {
             val = object.getStringValue();
             if (cfg.encrypt_use_aes()) {
-                Pl_Buffer bufpl("encrypted string");
-                Pl_AES_PDF pl("aes encrypt string", &bufpl, true, cur_data_key);
-                pl.writeString(val);
-                pl.finish();
-                val = QPDF_String(bufpl.getString()).unparse(true);
+                val = QPDF_String::unparse(pl::pipe<Pl_AES_PDF>(val, true, cur_data_key), true);
             } else {
-                auto tmp_ph = QUtil::make_unique_cstr(val);
-                char* tmp = tmp_ph.get();
-                size_t vlen = val.length();
-                RC4 rc4(
-                    QUtil::unsigned_char_pointer(cur_data_key),
-                    QIntC::to_int(cur_data_key.length()));
-                auto data = QUtil::unsigned_char_pointer(tmp);
-                rc4.process(data, vlen, data);
-                val = QPDF_String(std::string(tmp, vlen)).unparse();
+                // RC4 is a stream cipher, so we can encrypt in place.
+                RC4::process(cur_data_key, val);
+                val = QPDF_String::unparse(val);
             }
         } else if (flags & f_hex_string) {
-            val = QPDF_String(object.getStringValue()).unparse(true);
+            val = QPDF_String::unparse(object.getStringValue(), true);
         } else {
             val = object.unparseResolved();
         }
@@ -1860,21 +1979,41 @@ impl::Writer::unparseObject(
     }
 }
 
+// Size in bytes of the text writeObjectStreamOffsets produces: one "<id> <offset>" pair per entry
+// plus one separator character per entry (between entries and a trailing newline; both one byte in
+// qdf and non-qdf mode).
+static size_t
+objectStreamOffsetsSize(std::vector<qpdf_offset_t> const& offsets, int first_obj)
+{
+    auto width = [](unsigned long long v) {
+        size_t w = 1;
+        while (v >= 10) {
+            v /= 10;
+            ++w;
+        }
+        return w;
+    };
+    size_t size = 2 * offsets.size();
+    auto id = static_cast<unsigned long long>(first_obj);
+    for (auto offset: offsets) {
+        size += width(id++) + width(static_cast<unsigned long long>(offset));
+    }
+    return size;
+}
+
 void
 impl::Writer::writeObjectStreamOffsets(std::vector<qpdf_offset_t>& offsets, int first_obj)
 {
     qpdf_assert_debug(first_obj > 0);
     bool is_first = true;
-    auto id = std::to_string(first_obj) + ' ';
+    int id = first_obj;
     for (auto& offset: offsets) {
         if (is_first) {
             is_first = false;
         } else {
             write_qdf("\n").write_no_qdf(" ");
         }
-        write(id);
-        util::increment(id, 1);
-        write(offset);
+        write(id++).write(" ").write(offset);
     }
     write("\n");
 }
@@ -1894,9 +2033,10 @@ impl::Writer::writeObjectStream(QPDFObjectHandle object)
     qpdf_offset_t first = 0;
 
     // Generate stream itself.  We have to do this in two passes so we can calculate offsets in the
-    // first pass.
-    std::string stream_buffer_pass1;
-    std::string stream_buffer_pass2;
+    // first pass. The buffers are members so that their capacity carries over from one object
+    // stream to the next.
+    stream_buffer_pass1.clear();
+    stream_buffer_pass2.clear();
     int first_obj = -1;
     const bool compressed = cfg.compress_streams() && !cfg.qdf();
     {
@@ -1904,7 +2044,7 @@ impl::Writer::writeObjectStream(QPDFObjectHandle object)
         auto pp_ostream_pass1 = pipeline_stack.activate(stream_buffer_pass1);
 
         int count = -1;
-        for (auto const& og: object_stream_to_objects[old_id]) {
+        for (auto const& og: object_stream_to_objects[static_cast<size_t>(old_id)]) {
             ++count;
             int new_o = obj[og].renumber;
             if (first_obj == -1) {
@@ -1948,20 +2088,17 @@ impl::Writer::writeObjectStream(QPDFObjectHandle object)
             iter -= first;
         }
 
-        // Take one pass at writing pairs of numbers so we can get their size information
-        {
-            auto pp_discard = pipeline_stack.activate(true);
-            writeObjectStreamOffsets(offsets, first_obj);
-            first += pipeline->getCount();
-        }
+        // The offset table is decimal text whose size we can compute directly rather than taking
+        // a throwaway formatting pass to measure it.
+        auto offsets_size = objectStreamOffsetsSize(offsets, first_obj);
+        first += static_cast<qpdf_offset_t>(offsets_size);
 
         // Set up a stream to write the stream data into a buffer.
+        stream_buffer_pass2.reserve(offsets_size + stream_buffer_pass1.size());
         auto pp_ostream = pipeline_stack.activate(stream_buffer_pass2);
 
         writeObjectStreamOffsets(offsets, first_obj);
         write(stream_buffer_pass1);
-        stream_buffer_pass1.clear();
-        stream_buffer_pass1.shrink_to_fit();
         if (compressed) {
             stream_buffer_pass2 = pl::pipe<Pl_Flate>(stream_buffer_pass2, Pl_Flate::a_deflate);
         }
@@ -2001,7 +2138,7 @@ impl::Writer::writeObject(QPDFObjectHandle object, int object_stream_index)
     QPDFObjGen old_og = object.getObjGen();
 
     if (object_stream_index == -1 && old_og.getGen() == 0 &&
-        object_stream_to_objects.contains(old_og.getObj())) {
+        is_object_stream(old_og.getObj())) {
         writeObjectStream(object);
         return;
     }
@@ -2009,11 +2146,12 @@ impl::Writer::writeObject(QPDFObjectHandle object, int object_stream_index)
     indicateProgress(false, false);
     auto new_id = obj[old_og].renumber;
     if (cfg.qdf()) {
-        if (page_object_to_seq.contains(old_og)) {
-            write("%% Page ").write(page_object_to_seq[old_og]).write("\n");
+        auto const& special = special_streams[old_og];
+        if (special.page_seq) {
+            write("%% Page ").write(special.page_seq).write("\n");
         }
-        if (contents_to_page_seq.contains(old_og)) {
-            write("%% Contents for page ").write(contents_to_page_seq[old_og]).write("\n");
+        if (special.contents_page_seq) {
+            write("%% Contents for page ").write(special.contents_page_seq).write("\n");
         }
     }
     if (object_stream_index == -1) {
@@ -2098,7 +2236,10 @@ impl::Writer::generateID(bool encrypted)
         // the digest calculation for deterministic ID so that the same file converted with qpdf, in
         // that case, would have the same ID regardless of the output file's name.
 
-        std::string seed;
+        // Feed the seed material to the digest incrementally rather than concatenating it into a
+        // temporary string first. This matters for deterministic IDs, where the data is a digest
+        // of a large portion of the file's contents.
+        MD5 md5;
         if (cfg.deterministic_id()) {
             if (encrypted) {
                 throw std::runtime_error(
@@ -2109,24 +2250,32 @@ impl::Writer::generateID(bool encrypted)
                 throw std::logic_error(
                     "INTERNAL ERROR: QPDFWriter::generateID has no data for deterministic ID");
             }
-            seed += deterministic_id_data;
+            md5.encodeDataIncrementally(deterministic_id_data);
         } else {
-            seed += std::to_string(QUtil::get_current_time());
-            seed += filename;
-            seed += " ";
+            md5.encodeDataIncrementally(std::to_string(QUtil::get_current_time()));
+            md5.encodeDataIncrementally(filename);
+            md5.encodeDataIncrementally(" ");
         }
-        seed += " QPDF ";
+        md5.encodeDataIncrementally(" QPDF ");
         if (trailer.hasKey("/Info")) {
             for (auto const& item: trailer.getKey("/Info").as_dictionary()) {
                 if (item.second.isString()) {
-                    seed += " ";
-                    seed += item.second.getStringValue();
+                    md5.encodeDataIncrementally(" ");
+                    // The seed used to be hashed with encodeString, whose strlen semantics stopped
+                    // the whole seed at the first NUL byte. /Info values are the only pieces that
+                    // can contain one (e.g. UTF-16 strings), and IDs generated by older versions
+                    // must not change, so preserve that behavior exactly.
+                    std::string val = item.second.getStringValue();
+                    auto nul = val.find('\0');
+                    if (nul != std::string::npos) {
+                        md5.encodeDataIncrementally(val.substr(0, nul));
+                        break;
+                    }
+                    md5.encodeDataIncrementally(val);
                 }
             }
         }
 
-        MD5 md5;
-        md5.encodeString(seed.c_str());
         MD5::Digest digest;
         md5.digest(digest);
         result = std::string(reinterpret_cast<char*>(digest), sizeof(MD5::Digest));
@@ -2148,8 +2297,9 @@ impl::Writer::initializeSpecialStreams()
 {
     // Mark all page content streams in case we are filtering or normalizing.
     int num = 0;
+    special_streams.resize(objects.table_size());
     for (auto& page: pages) {
-        page_object_to_seq[page.getObjGen()] = ++num;
+        special_streams[page.getObjGen()].page_seq = ++num;
         QPDFObjectHandle contents = page.getKey("/Contents");
         std::vector<QPDFObjGen> contents_objects;
         if (contents.isArray()) {
@@ -2162,8 +2312,7 @@ impl::Writer::initializeSpecialStreams()
         }
 
         for (auto const& c: contents_objects) {
-            contents_to_page_seq[c] = num;
-            normalized_streams.insert(c);
+            special_streams[c].contents_page_seq = num;
         }
     }
 }
@@ -2196,11 +2345,14 @@ impl::Writer::preserveObjectStreams()
             if (iter->second.getType() == 2) {
                 // Pdf contains object streams.
                 obj.streams_empty = false;
+                auto first_og = iter->first;
                 auto eligible = objects.compressible_set();
-                // The object pointed to by iter may be a previous generation, in which case it is
-                // removed by compressible_set. We need to restart the loop (while the object
-                // table may contain multiple generations of an object).
-                for (iter = xref.cbegin(); iter != end; ++iter) {
+                // compressible_set may remove previous generations of objects from the xref
+                // table, invalidating iter, so re-enter the map instead of continuing with it.
+                // There is no need to rescan from the beginning: everything before the first
+                // type 2 entry has already been seen, and removals cannot add compressed objects
+                // in front of it.
+                for (iter = xref.lower_bound(first_og); iter != end; ++iter) {
                     if (iter->second.getType() == 2) {
                         auto id = static_cast<size_t>(iter->first.getObj());
                         if (id < eligible.size() && eligible[id]) {
@@ -2255,32 +2407,6 @@ impl::Writer::generateObjectStreams()
     }
 }
 
-Dictionary
-impl::Writer::trimmed_trailer()
-{
-    // Remove keys from the trailer that necessarily have to be replaced when writing the file.
-
-    Dictionary trailer = qpdf.getTrailer().unsafeShallowCopy();
-
-    // Remove encryption keys
-    trailer.erase("/ID");
-    trailer.erase("/Encrypt");
-
-    // Remove modification information
-    trailer.erase("/Prev");
-
-    // Remove all trailer keys that potentially come from a cross-reference stream
-    trailer.erase("/Index");
-    trailer.erase("/W");
-    trailer.erase("/Length");
-    trailer.erase("/Filter");
-    trailer.erase("/DecodeParms");
-    trailer.erase("/Type");
-    trailer.erase("/XRefStm");
-
-    return trailer;
-}
-
 // Make document extension level information direct as required by the spec.
 void
 impl::Writer::prepareFileForWrite()
@@ -2311,6 +2437,7 @@ impl::Writer::initializeTables(size_t extra)
     auto size = objects.table_size() + 100u + extra;
     obj.resize(size);
     new_obj.resize(size);
+    object_queue.reserve(size);
 }
 
 void
@@ -2395,18 +2522,24 @@ impl::Writer::doWriteSetup()
         }
 
         // Generate reverse mapping from object stream to objects
+        object_stream_to_objects.resize(obj.size());
         obj.forEach([this](auto id, auto const& item) -> void {
             if (item.object_stream > 0) {
-                auto& vec = object_stream_to_objects[item.object_stream];
+                auto idx = static_cast<size_t>(item.object_stream);
+                if (idx >= object_stream_to_objects.size()) {
+                    object_stream_to_objects.resize(idx + 1);
+                }
+                auto& vec = object_stream_to_objects[idx];
                 vec.emplace_back(id, item.gen);
                 if (max_ostream_index < vec.size()) {
                     ++max_ostream_index;
                 }
+                have_object_streams = true;
             }
         });
         --max_ostream_index;
 
-        if (object_stream_to_objects.empty()) {
+        if (!have_object_streams) {
             obj.streams_empty = true;
         } else {
             setMinimumPDFVersion("1.5");
@@ -2436,6 +2569,7 @@ impl::Writer::write()
     // Set up progress reporting. For linearized files, we write two passes. events_expected is an
     // approximation, but it's good enough for progress reporting, which is mostly a guess anyway.
     events_expected = QIntC::to_int(qpdf.getObjectCount() * (cfg.linearize() ? 2 : 1));
+    progress_increment = std::max(1, events_expected / 100);
 
     prepareFileForWrite();
 
@@ -2620,6 +2754,9 @@ impl::Writer::writeXRefTable(
         write("0000000000 65535 f \n");
         ++first;
     }
+    // Format each fixed-width entry on the stack rather than allocating a padded string per
+    // object.
+    char entry[] = "0000000000 00000 n \n";
     for (int i = first; i <= last; ++i) {
         qpdf_offset_t offset = 0;
         if (!suppress_offsets) {
@@ -2628,7 +2765,18 @@ impl::Writer::writeXRefTable(
                 offset += hint_length;
             }
         }
-        write(QUtil::int_to_string(offset, 10)).write(" 00000 n \n");
+        char digits[24];
+        auto* end = std::to_chars(digits, digits + sizeof(digits), offset).ptr;
+        auto n = static_cast<size_t>(end - digits);
+        if (n <= 10) {
+            std::memset(entry, '0', 10);
+            std::memcpy(entry + 10 - n, digits, n);
+            write(std::string_view(entry, 20));
+        } else {
+            // Offset too large for the conventional 10-digit field; preserve the historical
+            // behavior of writing it unpadded.
+            write(std::string_view(digits, n)).write(" 00000 n \n");
+        }
     }
     writeTrailer(which, size, false, prev, linearization_pass);
     write("\n");
@@ -2676,18 +2824,23 @@ impl::Writer::writeXRefStream(
     // openObject to do it.
     new_obj[xref_id].xref = QPDFXRefEntry(pipeline->getCount());
 
+    // The body size is known exactly, so fill a pre-sized buffer directly instead of routing
+    // each field through the pipeline stack. resize() value-initializes, so zero fields need no
+    // explicit stores.
     std::string xref_data;
     const bool compressed = cfg.compress_streams() && !cfg.qdf();
     {
-        auto pp_xref = pipeline_stack.activate(xref_data);
-
-        for (int i = first; i <= last; ++i) {
+        auto store_be = [](char* dst, unsigned long long val, unsigned int bytes) {
+            for (unsigned int i = bytes; i > 0; --i) {
+                *dst++ = static_cast<char>(val >> (8 * (i - 1)));
+            }
+        };
+        xref_data.resize(static_cast<size_t>(esize) * static_cast<size_t>(last - first + 1));
+        char* entry = xref_data.data();
+        for (int i = first; i <= last; ++i, entry += esize) {
             QPDFXRefEntry& e = new_obj[i].xref;
             switch (e.getType()) {
             case 0:
-                writeBinary(0, 1);
-                writeBinary(0, f1_size);
-                writeBinary(0, f2_size);
                 break;
 
             case 1:
@@ -2696,16 +2849,15 @@ impl::Writer::writeXRefStream(
                     if ((hint_id != 0) && (i != hint_id) && (offset >= hint_offset)) {
                         offset += hint_length;
                     }
-                    writeBinary(1, 1);
-                    writeBinary(QIntC::to_ulonglong(offset), f1_size);
-                    writeBinary(0, f2_size);
+                    entry[0] = 1;
+                    store_be(entry + 1, QIntC::to_ulonglong(offset), f1_size);
                 }
                 break;
 
             case 2:
-                writeBinary(2, 1);
-                writeBinary(QIntC::to_ulonglong(e.getObjStreamNumber()), f1_size);
-                writeBinary(QIntC::to_ulonglong(e.getObjStreamIndex()), f2_size);
+                entry[0] = 2;
+                store_be(entry + 1, QIntC::to_ulonglong(e.getObjStreamNumber()), f1_size);
+                store_be(entry + 1 + f1_size, QIntC::to_ulonglong(e.getObjStreamIndex()), f2_size);
                 break;
 
             default:
@@ -2758,10 +2910,16 @@ impl::Writer::writeLinearized()
 {
     // Optimize file and enqueue objects in order
 
-    std::map<int, int> stream_cache;
+    // Dense cache indexed by object id, following the same pattern as the writer's other
+    // per-object tables.
+    std::vector<int> stream_cache(obj.size(), 0);
 
     auto skip_stream_parameters = [this, &stream_cache](QPDFObjectHandle& stream) {
-        if (auto& result = stream_cache[stream.getObjectID()]) {
+        auto idx = static_cast<size_t>(stream.getObjectID());
+        if (idx >= stream_cache.size()) {
+            stream_cache.resize(idx + 1, 0);
+        }
+        if (auto& result = stream_cache[idx]) {
             return result;
         } else {
             return result = will_filter_stream(stream) ? 2 : 1;
@@ -2840,8 +2998,6 @@ impl::Writer::writeLinearized()
     int first_half_end = next_objid - 1;
     int first_trailer_size = next_objid;
 
-    int part4_end_marker = part4.back().getObjectID();
-    int part6_end_marker = part6.back().getObjectID();
     qpdf_offset_t space_before_zero = 0;
     qpdf_offset_t file_size = 0;
     qpdf_offset_t part6_end_offset = 0;
@@ -2857,11 +3013,15 @@ impl::Writer::writeLinearized()
         // faulty assumptions in calculateLinearizationData
         throw std::runtime_error("error encountered after writing part 4 of linearized data");
     }
+    // Queue positions of the last objects of parts 4 and 6, so the write loop can recognize the
+    // part boundaries by index instead of comparing object ids on every iteration.
+    size_t part4_end_idx = object_queue.size() - 1;
     next_objid = part6_first_obj;
     enqueuePart(part6);
     if (next_objid != after_part6) {
         throw std::runtime_error("error encountered after writing part 6 of linearized data");
     }
+    size_t part6_end_idx = object_queue.size() - 1;
     next_objid = second_half_first_obj;
     enqueuePart(part7);
     enqueuePart(part8);
@@ -2990,12 +3150,12 @@ impl::Writer::writeLinearized()
 
         // Parts 4 through 9
 
-        for (auto const& cur_object: object_queue) {
-            if (cur_object.getObjectID() == part6_end_marker) {
+        for (size_t i = 0; i < object_queue.size(); ++i) {
+            if (i == part6_end_idx) {
                 first_half_max_obj_offset = pipeline->getCount();
             }
-            writeObject(cur_object);
-            if (cur_object.getObjectID() == part4_end_marker) {
+            writeObject(qpdf.getObject(object_queue[i]));
+            if (i == part4_end_idx) {
                 if (encryption) {
                     writeEncryptionDictionary();
                 }
@@ -3006,7 +3166,7 @@ impl::Writer::writeLinearized()
                     write(hint_buffer);
                 }
             }
-            if (cur_object.getObjectID() == part6_end_marker) {
+            if (i == part6_end_idx) {
                 part6_end_offset = pipeline->getCount();
             }
         }
@@ -3082,17 +3242,11 @@ impl::Writer::writeLinearized()
             new_obj[hint_id].xref = QPDFXRefEntry(hint_offset1);
             if (lin_pass1_file) {
                 // Write some debugging information
-                fprintf(
-                    lin_pass1_file, "%% hint_offset=%s\n", std::to_string(hint_offset1).c_str());
-                fprintf(lin_pass1_file, "%% hint_length=%s\n", std::to_string(hint_length).c_str());
-                fprintf(
-                    lin_pass1_file,
-                    "%% second_xref_offset=%s\n",
-                    std::to_string(second_xref_offset).c_str());
-                fprintf(
-                    lin_pass1_file,
-                    "%% second_xref_end=%s\n",
-                    std::to_string(second_xref_end).c_str());
+                std::string info = "% hint_offset=" + std::to_string(hint_offset1) +
+                    "\n% hint_length=" + std::to_string(hint_length) +
+                    "\n% second_xref_offset=" + std::to_string(second_xref_offset) +
+                    "\n% second_xref_end=" + std::to_string(second_xref_end) + "\n";
+                fwrite(info.data(), 1, info.size(), lin_pass1_file);
                 fclose(lin_pass1_file);
                 lin_pass1_file = nullptr;
             }
@@ -3110,13 +3264,13 @@ impl::Writer::enqueueObjectsStandard()
     }
 
     // Put root first on queue.
-    auto trailer = trimmed_trailer();
+    Dictionary trailer = qpdf.getTrailer();
     enqueue(trailer["/Root"]);
 
     // Next place any other objects referenced from the trailer dictionary into the queue, handling
     // direct objects recursively. Root is already there, so enqueuing it a second time is a no-op.
     for (auto& item: trailer) {
-        if (!item.second.null()) {
+        if (!item.second.null() && !is_trimmed_trailer_key(item.first)) {
             enqueue(item.second);
         }
     }
@@ -3143,7 +3297,7 @@ impl::Writer::enqueueObjectsPCLm()
         }
     }
 
-    enqueue(trimmed_trailer()["/Root"]);
+    enqueue(Dictionary(qpdf.getTrailer())["/Root"]);
 }
 
 void
@@ -3167,10 +3321,11 @@ impl::Writer::indicateProgress(bool decrement, bool finished)
                  ? 0
                  : std::min(99, 1 + ((100 * events_seen) / events_expected)));
         progress_reporter->reportProgress(percentage);
-    }
-    int increment = std::max(1, (events_expected / 100));
-    while (events_seen >= next_progress_report) {
-        next_progress_report += increment;
+        // progress_increment is computed once when events_expected is set; the common
+        // no-report call does a single compare and returns above.
+        while (events_seen >= next_progress_report) {
+            next_progress_report += progress_increment;
+        }
     }
 }
 
@@ -3199,11 +3354,13 @@ impl::Writer::writeStandard()
         enqueueObjectsStandard();
     }
 
-    // Now start walking queue, outputting each object.
+    // Now start walking queue, outputting each object. The queue grows as writeObject enqueues
+    // referenced objects, so the loop condition re-reads size(); the index itself is bounded by
+    // that check, making at()'s bounds check redundant.
     while (object_queue_front < object_queue.size()) {
-        QPDFObjectHandle cur_object = object_queue.at(object_queue_front);
+        QPDFObjGen cur_og = object_queue[object_queue_front];
         ++object_queue_front;
-        writeObject(cur_object);
+        writeObject(qpdf.getObject(cur_og));
     }
 
     // Write out the encryption dictionary, if any
@@ -3213,7 +3370,7 @@ impl::Writer::writeStandard()
 
     // Now write out xref.  next_objid is now the number of objects.
     qpdf_offset_t xref_offset = pipeline->getCount();
-    if (object_stream_to_objects.empty()) {
+    if (!have_object_streams) {
         // Write regular cross-reference table
         writeXRefTable(t_normal, 0, next_objid - 1, next_objid);
     } else {
@@ -3227,6 +3384,6 @@ impl::Writer::writeStandard()
         QTC::TC(
             "qpdf",
             "QPDFWriter standard deterministic ID",
-            object_stream_to_objects.empty() ? 0 : 1);
+            have_object_streams ? 1 : 0);
     }
 }
@@ -3,14 +3,21 @@
 #include <qpdf/QPDFObjectHandle_private.hh>
 #include <qpdf/QUtil.hh>
 
+#include <array>
+
 // DO NOT USE ctype -- it is locale dependent for some things, and it's not worth the risk of
 // including it in case it may accidentally be used.
 
-static bool
-is_iso_latin1_printable(char ch)
-{
-    return (((ch >= 32) && (ch <= 126)) || (static_cast<unsigned char>(ch) >= 160));
-}
+// Characters that can be copied verbatim into a literal string: ISO-Latin-1 printable and not one
+// of the escaped delimiters.
+static constexpr auto literal_verbatim = []() {
+    std::array<bool, 256> t{};
+    for (int c = 0; c < 256; ++c) {
+        t[static_cast<size_t>(c)] =
+            ((c >= 32 && c <= 126) || c >= 160) && c != '(' && c != ')' && c != '\\';
+    }
+    return t;
+}();
 
 std::shared_ptr<QPDFObject>
 QPDF_String::create_utf16(std::string const& utf8_val)
@@ -33,7 +40,7 @@ QPDF_String::writeJSON(int json_version, JSON::Writer& p)
         if (QUtil::is_utf16(val) || QUtil::is_explicit_utf8(val)) {
             p << "\"u:" << JSON::Writer::encode_string(candidate) << "\"";
             return;
-        } else if (!useHexString()) {
+        } else if (!useHexString(val)) {
             std::string test;
             if (QUtil::utf8_to_pdf_doc(candidate, test, '?') && (test == val)) {
                 // This is a PDF-doc string that can be losslessly encoded as Unicode.
@@ -46,7 +53,7 @@ QPDF_String::writeJSON(int json_version, JSON::Writer& p)
 }
 
 bool
-QPDF_String::useHexString() const
+QPDF_String::useHexString(std::string_view val)
 {
     // Heuristic: use the hexadecimal representation of a string if there are any non-printable (in
     // PDF Doc encoding) characters or if too large of a proportion of the string consists of
@@ -67,9 +74,9 @@ QPDF_String::useHexString() const
 }
 
 std::string
-QPDF_String::unparse(bool force_binary)
+QPDF_String::unparse(std::string_view val, bool force_binary)
 {
-    bool use_hexstring = force_binary || useHexString();
+    bool use_hexstring = force_binary || useHexString(val);
     std::string result;
     if (use_hexstring) {
         static auto constexpr hexchars = "0123456789abcdef";
@@ -81,9 +88,20 @@ QPDF_String::unparse(bool force_binary)
         }
         result += '>';
     } else {
+        result.reserve(val.length() + 2);
         result += "(";
-        for (unsigned int i = 0; i < val.length(); ++i) {
-            char ch = val.at(i);
+        size_t len = val.length();
+        for (size_t i = 0; i < len;) {
+            // Copy runs of verbatim characters in one append rather than byte by byte.
+            size_t start = i;
+            while (i < len && literal_verbatim[static_cast<unsigned char>(val[i])]) {
+                ++i;
+            }
+            result.append(val, start, i - start);
+            if (i == len) {
+                break;
+            }
+            char ch = val[i++];
             switch (ch) {
             case '\n':
                 result += "\\n";
@@ -118,13 +136,9 @@ QPDF_String::unparse(bool force_binary)
                 break;
 
             default:
-                if (is_iso_latin1_printable(ch)) {
-                    result += val.at(i);
-                } else {
-                    result += "\\" +
-                        QUtil::int_to_string_base(
-                                  static_cast<int>(static_cast<unsigned char>(ch)), 8, 3);
-                }
+                result += "\\" +
+                    QUtil::int_to_string_base(
+                              static_cast<int>(static_cast<unsigned char>(ch)), 8, 3);
                 break;
             }
         }
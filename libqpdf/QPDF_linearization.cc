@@ -17,8 +17,12 @@
 #include <qpdf/Util.hh>
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 #include <cstring>
+#include <optional>
+#include <tuple>
 #include <utility>
 
 using namespace qpdf;
@@ -26,24 +30,46 @@ using namespace std::literals;
 
 using Lin = QPDF::Doc::Linearization;
 
+// Normalize an appended-to payload vector of the optimization maps to the sorted, duplicate-free
+// form the rest of the linearization code expects.
+template <class T>
+static void
+sort_unique(std::vector<T>& vec)
+{
+    std::sort(vec.begin(), vec.end());
+    vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+}
+
 template <class T, class int_type>
 static void
 load_vector_int(
     BitStream& bit_stream, int nitems, std::vector<T>& vec, int bits_wanted, int_type T::* field)
 {
-    bool append = vec.empty();
     // nitems times, read bits_wanted from the given bit stream, storing results in the ith vector
     // entry.
-
-    for (size_t i = 0; i < QIntC::to_size(nitems); ++i) {
-        if (append) {
+    size_t count = QIntC::to_size(nitems);
+    size_t bits = QIntC::to_size(bits_wanted);
+    if (vec.empty() && count > bit_stream.bitsAvailable() / (bits ? bits : 1)) {
+        // nitems comes from the file and the stream cannot possibly hold that many items. Grow
+        // one entry per read as before so that a truncated stream throws the bit stream overflow
+        // error rather than this turning into a huge allocation.
+        for (size_t i = 0; i < count; ++i) {
             vec.push_back(T());
+            vec.back().*field = bit_stream.getBitsInt(bits);
+        }
+    } else {
+        // Size the vector up front (the first column load of a table gets an empty vector; later
+        // columns fill in the entries it created) so the loop is a plain indexed store.
+        if (vec.empty()) {
+            vec.resize(count);
+        }
+        util::assertion(
+            std::cmp_equal(vec.size(), nitems), "vector has wrong size in load_vector_int" //
+        );
+        for (size_t i = 0; i < count; ++i) {
+            vec[i].*field = bit_stream.getBitsInt(bits);
         }
-        vec.at(i).*field = bit_stream.getBitsInt(QIntC::to_size(bits_wanted));
     }
-    util::assertion(
-        std::cmp_equal(vec.size(), nitems), "vector has wrong size in load_vector_int" //
-    );
     // The PDF spec says that each hint table starts at a byte boundary.  Each "row" actually must
     // start on a byte boundary.
     bit_stream.skipToNextByte();
@@ -92,18 +118,13 @@ Lin::ObjUser::ObjUser(user_e type, std::string const& key) :
 bool
 Lin::ObjUser::operator<(ObjUser const& rhs) const
 {
-    if (ou_type < rhs.ou_type) {
-        return true;
-    }
-    if (ou_type == rhs.ou_type) {
-        if (pageno < rhs.pageno) {
-            return true;
-        }
-        if (pageno == rhs.pageno) {
-            return key < rhs.key;
-        }
-    }
-    return false;
+    return std::tie(ou_type, pageno, key) < std::tie(rhs.ou_type, rhs.pageno, rhs.key);
+}
+
+bool
+Lin::ObjUser::operator==(ObjUser const& rhs) const
+{
+    return ou_type == rhs.ou_type && pageno == rhs.pageno && key == rhs.key;
 }
 
 Lin::UpdateObjectMapsFrame::UpdateObjectMapsFrame(
@@ -187,8 +208,17 @@ Lin::optimize_internal(
 
     ObjUser root_ou = ObjUser(ObjUser::ou_root);
     auto root_og = root.id_gen();
-    obj_user_to_objects_[root_ou].insert(root_og);
-    object_to_obj_users_[root_og].insert(root_ou);
+    obj_user_to_objects_[root_ou].push_back(root_og);
+    object_to_obj_users_[root_og].push_back(root_ou);
+
+    // The traversal appends to the payload vectors; sort and deduplicate them once now rather than
+    // paying for set insertion on every reference.
+    for (auto& [ou, ogs]: obj_user_to_objects_) {
+        sort_unique(ogs);
+    }
+    for (auto& [og, ous]: object_to_obj_users_) {
+        sort_unique(ous);
+    }
 
     filterCompressedObjects(object_stream_data);
 }
@@ -201,16 +231,22 @@ Lin::updateObjectMaps(
 {
     QPDFObjGen::set visited;
     std::vector<UpdateObjectMapsFrame> pending;
+    // Wide dictionaries push one frame per child; give the stack some initial capacity so typical
+    // traversals never reallocate it.
+    pending.reserve(64);
     pending.emplace_back(first_ou, first_oh, true);
     // Traverse the object tree from this point taking care to avoid crossing page boundaries.
-    std::unique_ptr<ObjUser> thumb_ou;
+    std::optional<ObjUser> thumb_ou;
     while (!pending.empty()) {
         auto cur = pending.back();
         pending.pop_back();
 
+        // Resolve the type once; the predicates below would each re-resolve it.
+        auto tc = cur.oh.resolved_type_code();
+
         bool is_page_node = false;
 
-        if (cur.oh.isDictionaryOfType("/Page")) {
+        if (tc == ::ot_dictionary && cur.oh.isDictionaryOfType("/Page")) {
             is_page_node = true;
             if (!cur.top) {
                 continue;
@@ -223,17 +259,17 @@ Lin::updateObjectMaps(
                 QTC::TC("qpdf", "QPDF opt loop detected");
                 continue;
             }
-            obj_user_to_objects_[cur.ou].insert(og);
-            object_to_obj_users_[og].insert(cur.ou);
+            obj_user_to_objects_[cur.ou].push_back(og);
+            object_to_obj_users_[og].push_back(cur.ou);
         }
 
-        if (cur.oh.isArray()) {
+        if (tc == ::ot_array) {
             for (auto const& item: cur.oh.as_array()) {
                 pending.emplace_back(cur.ou, item, false);
             }
-        } else if (cur.oh.isDictionary() || cur.oh.isStream()) {
+        } else if (tc == ::ot_dictionary || tc == ::ot_stream) {
             QPDFObjectHandle dict = cur.oh;
-            bool is_stream = cur.oh.isStream();
+            bool is_stream = tc == ::ot_stream;
             int ssp = 0;
             if (is_stream) {
                 dict = cur.oh.getDict();
@@ -247,16 +283,16 @@ Lin::updateObjectMaps(
                     continue;
                 }
 
-                if (is_page_node && (key == "/Thumb")) {
+                if (is_page_node && (key == "/Thumb"sv)) {
                     // Traverse page thumbnail dictionaries as a special case. There can only ever
                     // be one /Thumb key on a page, and we see at most one page node per call.
-                    thumb_ou = std::make_unique<ObjUser>(ObjUser::ou_thumb, cur.ou.pageno);
+                    thumb_ou.emplace(ObjUser::ou_thumb, cur.ou.pageno);
                     pending.emplace_back(*thumb_ou, dict.getKey(key), false);
-                } else if (is_page_node && (key == "/Parent")) {
+                } else if (is_page_node && (key == "/Parent"sv)) {
                     // Don't traverse back up the page tree
                 } else if (
-                    ((ssp >= 1) && (key == "/Length")) ||
-                    ((ssp >= 2) && ((key == "/Filter") || (key == "/DecodeParms")))) {
+                    ((ssp >= 1) && (key == "/Length"sv)) ||
+                    ((ssp >= 2) && ((key == "/Filter"sv) || (key == "/DecodeParms"sv)))) {
                     // Don't traverse into stream parameters that we are not going to write.
                 } else {
                     pending.emplace_back(cur.ou, value, false);
@@ -277,31 +313,64 @@ Lin::filterCompressedObjects(std::map<int, int> const& object_stream_data)
     // objects.  If something is a user of a compressed object, then it is really a user of the
     // object stream that contains it.
 
-    std::map<ObjUser, std::set<QPDFObjGen>> t_obj_user_to_objects;
-    std::map<QPDFObjGen, std::set<ObjUser>> t_object_to_obj_users;
+    std::map<ObjUser, std::vector<QPDFObjGen>> t_obj_user_to_objects;
+    std::map<QPDFObjGen, std::vector<ObjUser>> t_object_to_obj_users;
 
+    // The two maps are exact inverses, so one pass over the forward map can rebuild both: each
+    // (ou, og) pair resolved here also determines an entry of the inverse map.
     for (auto const& [ou, ogs]: obj_user_to_objects_) {
         for (auto const& og: ogs) {
             auto i2 = object_stream_data.find(og.getObj());
-            if (i2 == object_stream_data.end()) {
-                t_obj_user_to_objects[ou].insert(og);
-            } else {
-                t_obj_user_to_objects[ou].insert({i2->second, 0});
-            }
+            auto t_og = i2 == object_stream_data.end() ? og : QPDFObjGen(i2->second, 0);
+            t_obj_user_to_objects[ou].push_back(t_og);
+            t_object_to_obj_users[t_og].push_back(ou);
         }
     }
 
-    for (auto const& [og, ous]: object_to_obj_users_) {
-        for (auto const& ou: ous) {
-            auto i2 = object_stream_data.find(og.getObj());
-            if (i2 == object_stream_data.end()) {
-                t_object_to_obj_users[og].insert(ou);
-            } else {
-                t_object_to_obj_users[{i2->second, 0}].insert(ou);
-            }
+    // Multiple members of one object stream collapse to the same stream object, so the rewritten
+    // vectors can contain duplicates.
+    for (auto& [ou, ogs]: t_obj_user_to_objects) {
+        sort_unique(ogs);
+    }
+    for (auto& [og, ous]: t_object_to_obj_users) {
+        sort_unique(ous);
+    }
+
+    obj_user_to_objects_ = std::move(t_obj_user_to_objects);
+    object_to_obj_users_ = std::move(t_object_to_obj_users);
+}
+
+void
+Lin::filterCompressedObjects(std::vector<int> const& object_stream_data)
+{
+    if (object_stream_data.empty()) {
+        return;
+    }
+
+    // As for the std::map variant, but the object stream membership lookup is an indexed load.
+
+    std::map<ObjUser, std::vector<QPDFObjGen>> t_obj_user_to_objects;
+    std::map<QPDFObjGen, std::vector<ObjUser>> t_object_to_obj_users;
+
+    for (auto const& [ou, ogs]: obj_user_to_objects_) {
+        for (auto const& og: ogs) {
+            auto id = toS(og.getObj());
+            auto i2 = id < object_stream_data.size() ? object_stream_data[id] : 0;
+            auto t_og = i2 == 0 ? og : QPDFObjGen(i2, 0);
+            t_obj_user_to_objects[ou].push_back(t_og);
+            t_object_to_obj_users[t_og].push_back(ou);
         }
     }
 
+    // Multiple members of one object stream collapse to the same stream object, so the rewritten
+    // vectors can contain duplicates.
+    for (auto& [ou, ogs]: t_obj_user_to_objects) {
+        sort_unique(ogs);
+    }
+    for (auto& [og, ous]: t_object_to_obj_users) {
+        sort_unique(ous);
+    }
+
     obj_user_to_objects_ = std::move(t_obj_user_to_objects);
     object_to_obj_users_ = std::move(t_object_to_obj_users);
 }
@@ -317,32 +386,29 @@ Lin::filterCompressedObjects(QPDFWriter::ObjTable const& obj)
     // objects.  If something is a user of a compressed object, then it is really a user of the
     // object stream that contains it.
 
-    std::map<ObjUser, std::set<QPDFObjGen>> t_obj_user_to_objects;
-    std::map<QPDFObjGen, std::set<ObjUser>> t_object_to_obj_users;
+    std::map<ObjUser, std::vector<QPDFObjGen>> t_obj_user_to_objects;
+    std::map<QPDFObjGen, std::vector<ObjUser>> t_object_to_obj_users;
 
+    // The two maps are exact inverses, so one pass over the forward map can rebuild both: each
+    // (ou, og) pair resolved here also determines an entry of the inverse map.
     for (auto const& [ou, ogs]: obj_user_to_objects_) {
         for (auto const& og: ogs) {
             if (obj.contains(og)) {
-                if (auto const& i2 = obj[og].object_stream; i2 <= 0) {
-                    t_obj_user_to_objects[ou].insert(og);
-                } else {
-                    t_obj_user_to_objects[ou].insert(QPDFObjGen(i2, 0));
-                }
+                auto i2 = obj[og].object_stream;
+                auto t_og = i2 <= 0 ? og : QPDFObjGen(i2, 0);
+                t_obj_user_to_objects[ou].push_back(t_og);
+                t_object_to_obj_users[t_og].push_back(ou);
             }
         }
     }
 
-    for (auto const& [og, ous]: object_to_obj_users_) {
-        if (obj.contains(og)) {
-            // Loop over obj_users.
-            for (auto const& ou: ous) {
-                if (auto i2 = obj[og].object_stream; i2 <= 0) {
-                    t_object_to_obj_users[og].insert(ou);
-                } else {
-                    t_object_to_obj_users[{i2, 0}].insert(ou);
-                }
-            }
-        }
+    // Multiple members of one object stream collapse to the same stream object, so the rewritten
+    // vectors can contain duplicates.
+    for (auto& [ou, ogs]: t_obj_user_to_objects) {
+        sort_unique(ogs);
+    }
+    for (auto& [og, ous]: t_object_to_obj_users) {
+        sort_unique(ous);
     }
 
     obj_user_to_objects_ = std::move(t_obj_user_to_objects);
@@ -705,11 +771,16 @@ Lin::checkLinearizationInternal()
 
     // T: offset of whitespace character preceding xref entry for object 0
     m->file->seek(p.xref_zero_offset, SEEK_SET);
+    // Scan a chunk at a time rather than pairing a read with a seek for every whitespace byte.
     while (true) {
-        char ch;
-        m->file->read(&ch, 1);
-        if (!(ch == ' ' || ch == '\r' || ch == '\n')) {
-            m->file->seek(-1, SEEK_CUR);
+        char buf[64];
+        size_t len = m->file->read(buf, sizeof(buf));
+        size_t ws = 0;
+        while (ws < len && (buf[ws] == ' ' || buf[ws] == '\r' || buf[ws] == '\n')) {
+            ++ws;
+        }
+        if (ws < len || len == 0) {
+            m->file->seek(toO(ws) - toO(len), SEEK_CUR);
             break;
         }
     }
@@ -737,10 +808,15 @@ Lin::checkLinearizationInternal()
     // make changes.  If it has to, then the file is not properly linearized.  We use the xref table
     // to figure out which objects are compressed and which are uncompressed.
     { // local scope
-        std::map<int, int> object_stream_data;
+        // Dense table indexed by object id; left empty when there are no compressed objects.
+        // Object ids are small and the xref table is sorted, so the last key bounds the size.
+        std::vector<int> object_stream_data;
         for (auto const& [og, entry]: m->xref_table) {
             if (entry.getType() == 2) {
-                object_stream_data[og.getObj()] = entry.getObjStreamNumber();
+                if (object_stream_data.empty()) {
+                    object_stream_data.resize(toS(m->xref_table.rbegin()->first.getObj()) + 1);
+                }
+                object_stream_data[toS(og.getObj())] = entry.getObjStreamNumber();
             }
         }
         optimize_internal(object_stream_data, false, nullptr);
@@ -763,8 +839,9 @@ Lin::checkLinearizationInternal()
     for (auto const& oh: part6_) {
         QPDFObjGen og(oh.getObjGen());
         // All objects have to have been dereferenced to be classified.
-        util::assertion(m->obj_cache.contains(og), "linearization part6 object not in cache");
-        ObjCache const& oc = m->obj_cache[og];
+        auto it = m->obj_cache.find(og);
+        util::assertion(it != m->obj_cache.end(), "linearization part6 object not in cache");
+        ObjCache const& oc = it->second;
         min_E = std::max(min_E, oc.end_before_space);
         max_E = std::max(max_E, oc.end_after_space);
     }
@@ -776,7 +853,7 @@ Lin::checkLinearizationInternal()
 
     // Check hint tables
 
-    std::map<int, int> shared_idx_to_obj;
+    std::vector<int> shared_idx_to_obj;
     checkHSharedObject(all_pages, shared_idx_to_obj);
     checkHPageOffset(all_pages, shared_idx_to_obj);
     checkHOutlines();
@@ -785,17 +862,19 @@ Lin::checkLinearizationInternal()
 qpdf_offset_t
 Lin::maxEnd(ObjUser const& ou)
 {
+    auto ou_it = obj_user_to_objects_.find(ou);
     no_ci_stop_if(
-        !obj_user_to_objects_.contains(ou),
+        ou_it == obj_user_to_objects_.end(),
         "no entry in object user table for requested object user" //
     );
 
     qpdf_offset_t end = 0;
-    for (auto const& og: obj_user_to_objects_[ou]) {
+    for (auto const& og: ou_it->second) {
+        auto it = m->obj_cache.find(og);
         no_ci_stop_if(
-            !m->obj_cache.contains(og), "unknown object referenced in object user table" //
+            it == m->obj_cache.end(), "unknown object referenced in object user table" //
         );
-        end = std::max(end, m->obj_cache[og].end_after_space);
+        end = std::max(end, it->second.end_after_space);
     }
     return end;
 }
@@ -803,16 +882,23 @@ Lin::maxEnd(ObjUser const& ou)
 qpdf_offset_t
 Lin::getLinearizationOffset(QPDFObjGen og)
 {
-    QPDFXRefEntry const& entry = m->xref_table[og];
-    auto typ = entry.getType();
-    if (typ == 1) {
-        return entry.getOffset();
+    // For compressed objects, return the offset of the object stream that contains them. The
+    // containing stream is itself uncompressed, so this normally takes a single hop; the hop
+    // bound guards against damaged files whose object streams claim to contain each other, which
+    // would have recursed without limit before this was a loop.
+    for (int hops = 0; hops < 1000; ++hops) {
+        QPDFXRefEntry const& entry = m->xref_table[og];
+        auto typ = entry.getType();
+        if (typ == 1) {
+            return entry.getOffset();
+        }
+        no_ci_stop_if(
+            typ != 2, "getLinearizationOffset called for xref entry not of type 1 or 2" //
+        );
+        og = QPDFObjGen(entry.getObjStreamNumber(), 0);
     }
-    no_ci_stop_if(
-        typ != 2, "getLinearizationOffset called for xref entry not of type 1 or 2" //
-    );
-    // For compressed objects, return the offset of the object stream that contains them.
-    return getLinearizationOffset({entry.getObjStreamNumber(), 0});
+    stopOnError("getLinearizationOffset: loop in object stream membership");
+    return 0; // unreachable
 }
 
 QPDFObjectHandle
@@ -824,6 +910,19 @@ Lin::getUncompressedObject(QPDFObjectHandle& obj, std::map<int, int> const& obje
     return qpdf.getObject((*(object_stream_data.find(obj.getObjectID()))).second, 0);
 }
 
+QPDFObjectHandle
+Lin::getUncompressedObject(QPDFObjectHandle& obj, std::vector<int> const& object_stream_data)
+{
+    if (obj.null()) {
+        return obj;
+    }
+    auto id = toS(obj.getObjectID());
+    if (id >= object_stream_data.size() || object_stream_data[id] == 0) {
+        return obj;
+    }
+    return qpdf.getObject(object_stream_data[id], 0);
+}
+
 QPDFObjectHandle
 Lin::getUncompressedObject(QPDFObjectHandle& oh, QPDFWriter::ObjTable const& obj)
 {
@@ -842,12 +941,13 @@ Lin::lengthNextN(int first_object, int n)
     for (int i = 0; i < n; ++i) {
         QPDFObjGen og(first_object + i, 0);
         if (m->xref_table.contains(og)) {
+            auto it = m->obj_cache.find(og);
             no_ci_stop_if(
-                !m->obj_cache.contains(og),
+                it == m->obj_cache.end(),
                 "found unknown object while calculating length for linearization data" //
             );
 
-            length += toI(m->obj_cache[og].end_after_space - getLinearizationOffset(og));
+            length += toI(it->second.end_after_space - getLinearizationOffset(og));
         } else {
             linearizationWarning(
                 "no xref table entry for " + std::to_string(first_object + i) + " 0");
@@ -858,7 +958,7 @@ Lin::lengthNextN(int first_object, int n)
 
 void
 Lin::checkHPageOffset(
-    std::vector<QPDFObjectHandle> const& pages, std::map<int, int>& shared_idx_to_obj)
+    std::vector<QPDFObjectHandle> const& pages, std::vector<int> const& shared_idx_to_obj)
 {
     // Implementation note 126 says Acrobat always sets delta_content_offset and
     // delta_content_length in the page offset header dictionary to 0.  It also states that
@@ -883,6 +983,18 @@ Lin::checkHPageOffset(
         linearizationWarning("first page object offset mismatch");
     }
 
+    // Flat copy of the computed shared objects' numbers. The loop below reads only this field of
+    // each entry, re-indexing the same entries for every page that shares them.
+    std::vector<int> shared_objs;
+    shared_objs.reserve(c_shared_object_data_.entries.size());
+    for (auto const& entry: c_shared_object_data_.entries) {
+        shared_objs.push_back(entry.object);
+    }
+
+    // Reused across pages; cleared per iteration so the capacity survives.
+    std::vector<int> hint_shared;
+    std::vector<int> computed_shared;
+
     for (size_t pageno = 0; pageno < npages; ++pageno) {
         QPDFObjGen page_og(pages.at(pageno).getObjGen());
         int first_object = page_og.getObj();
@@ -916,8 +1028,8 @@ Lin::checkHPageOffset(
         offset += h_length;
 
         // Translate shared object indexes to object numbers.
-        std::set<int> hint_shared;
-        std::set<int> computed_shared;
+        hint_shared.clear();
+        computed_shared.clear();
 
         if (pageno == 0 && he.nshared_objects > 0) {
             // pdlin and Acrobat both do this even though the spec states clearly and unambiguously
@@ -925,28 +1037,31 @@ Lin::checkHPageOffset(
             linearizationWarning("page 0 has shared identifier entries");
         }
 
-        for (size_t i = 0; i < toS(he.nshared_objects); ++i) {
-            int idx = he.shared_identifiers.at(i);
+        // The loaders fill shared_identifiers with exactly nshared_objects items, so iterating
+        // the vector avoids a bounds-checked index per element.
+        for (int idx: he.shared_identifiers) {
             no_ci_stop_if(
-                !shared_idx_to_obj.contains(idx),
+                idx < 0 || toS(idx) >= shared_idx_to_obj.size(),
                 "unable to get object for item in shared objects hint table");
 
-            hint_shared.insert(shared_idx_to_obj[idx]);
+            hint_shared.push_back(shared_idx_to_obj[toS(idx)]);
         }
 
-        for (size_t i = 0; i < toS(ce.nshared_objects); ++i) {
-            int idx = ce.shared_identifiers.at(i);
+        for (int idx: ce.shared_identifiers) {
             no_ci_stop_if(
-                idx >= c_shared_object_data_.nshared_total,
+                toS(idx) >= shared_objs.size(),
                 "index out of bounds for shared object hint table" //
             );
 
-            int obj = c_shared_object_data_.entries.at(toS(idx)).object;
-            computed_shared.insert(obj);
+            computed_shared.push_back(shared_objs[toS(idx)]);
         }
 
+        // Sort and dedup so iteration order and duplicate handling match the former sets.
+        sort_unique(hint_shared);
+        sort_unique(computed_shared);
+
         for (int iter: hint_shared) {
-            if (!computed_shared.contains(iter)) {
+            if (!std::binary_search(computed_shared.begin(), computed_shared.end(), iter)) {
                 // pdlin puts thumbnails here even though it shouldn't
                 linearizationWarning(
                     "page " + std::to_string(pageno) + ": shared object " + std::to_string(iter) +
@@ -955,7 +1070,7 @@ Lin::checkHPageOffset(
         }
 
         for (int iter: computed_shared) {
-            if (!hint_shared.contains(iter)) {
+            if (!std::binary_search(hint_shared.begin(), hint_shared.end(), iter)) {
                 // Acrobat does not put some things including at least built-in fonts and procsets
                 // here, at least in some cases.
                 linearizationWarning(
@@ -967,7 +1082,7 @@ Lin::checkHPageOffset(
 }
 
 void
-Lin::checkHSharedObject(std::vector<QPDFObjectHandle> const& pages, std::map<int, int>& idx_to_obj)
+Lin::checkHSharedObject(std::vector<QPDFObjectHandle> const& pages, std::vector<int>& idx_to_obj)
 {
     // Implementation note 125 says shared object groups always contain only one object.
     // Implementation note 128 says that Acrobat always nbits_nobjects to zero.  Implementation note
@@ -990,6 +1105,10 @@ Lin::checkHSharedObject(std::vector<QPDFObjectHandle> const& pages, std::map<int
         // The first nshared_first_page objects are consecutive objects starting with the first page
         // object.  The rest are consecutive starting from the first_shared_obj object.
         int cur_object = pages.at(0).getObjectID();
+        if (so.nshared_total > 0) {
+            // Shared identifiers are dense, so a flat array replaces the former map.
+            idx_to_obj.assign(toS(so.nshared_total), 0);
+        }
         for (int i = 0; i < so.nshared_total; ++i) {
             if (i == so.nshared_first_page) {
                 QTC::TC("qpdf", "QPDF lin check shared past first page");
@@ -1020,7 +1139,7 @@ Lin::checkHSharedObject(std::vector<QPDFObjectHandle> const& pages, std::map<int
                 }
             }
 
-            idx_to_obj[i] = cur_object;
+            idx_to_obj[toS(i)] = cur_object;
             HSharedObjectEntry& se = so.entries.at(toS(i));
             int nobjects = se.nobjects_minus_one + 1;
             int length = lengthNextN(cur_object, nobjects);
@@ -1108,17 +1227,17 @@ Lin::dumpLinearizationDataInternal()
 {
     auto& info = *cf.log()->getInfo();
 
-    info << m->file->getName() << ": linearization data:\n\n";
-
-    info << "file_size: " << linp_.file_size << "\n"
-         << "first_page_object: " << linp_.first_page_object << "\n"
-         << "first_page_end: " << linp_.first_page_end << "\n"
-         << "npages: " << linp_.npages << "\n"
-         << "xref_zero_offset: " << linp_.xref_zero_offset << "\n"
-         << "first_page: " << linp_.first_page << "\n"
-         << "H_offset: " << linp_.H_offset << "\n"
-         << "H_length: " << linp_.H_length << "\n"
-         << "\n";
+    // Batch each section into one string so the pipeline sees one write per section rather than
+    // one per field.
+    info << m->file->getName() + ": linearization data:\n\n" + //
+            "file_size: " + std::to_string(linp_.file_size) + "\n" +
+            "first_page_object: " + std::to_string(linp_.first_page_object) + "\n" +
+            "first_page_end: " + std::to_string(linp_.first_page_end) + "\n" +
+            "npages: " + std::to_string(linp_.npages) + "\n" +
+            "xref_zero_offset: " + std::to_string(linp_.xref_zero_offset) + "\n" +
+            "first_page: " + std::to_string(linp_.first_page) + "\n" +
+            "H_offset: " + std::to_string(linp_.H_offset) + "\n" +
+            "H_length: " + std::to_string(linp_.H_length) + "\n\n";
 
     info << "Page Offsets Hint Table\n\n";
     dumpHPageOffset();
@@ -1145,75 +1264,86 @@ Lin::adjusted_offset(qpdf_offset_t offset)
 void
 Lin::dumpHPageOffset()
 {
-    auto& info = *cf.log()->getInfo();
     HPageOffset& t = page_offset_hints_;
-    info << "min_nobjects: " << t.min_nobjects << "\n"
-         << "first_page_offset: " << adjusted_offset(t.first_page_offset) << "\n"
-         << "nbits_delta_nobjects: " << t.nbits_delta_nobjects << "\n"
-         << "min_page_length: " << t.min_page_length << "\n"
-         << "nbits_delta_page_length: " << t.nbits_delta_page_length << "\n"
-         << "min_content_offset: " << t.min_content_offset << "\n"
-         << "nbits_delta_content_offset: " << t.nbits_delta_content_offset << "\n"
-         << "min_content_length: " << t.min_content_length << "\n"
-         << "nbits_delta_content_length: " << t.nbits_delta_content_length << "\n"
-         << "nbits_nshared_objects: " << t.nbits_nshared_objects << "\n"
-         << "nbits_shared_identifier: " << t.nbits_shared_identifier << "\n"
-         << "nbits_shared_numerator: " << t.nbits_shared_numerator << "\n"
-         << "shared_denominator: " << t.shared_denominator << "\n";
-
+    // Format everything into one buffer and hand the pipeline a single write; per-field writes
+    // add up over thousands of pages.
+    std::string buf = "min_nobjects: " + std::to_string(t.min_nobjects) + "\n" +
+        "first_page_offset: " + std::to_string(adjusted_offset(t.first_page_offset)) + "\n" +
+        "nbits_delta_nobjects: " + std::to_string(t.nbits_delta_nobjects) + "\n" +
+        "min_page_length: " + std::to_string(t.min_page_length) + "\n" +
+        "nbits_delta_page_length: " + std::to_string(t.nbits_delta_page_length) + "\n" +
+        "min_content_offset: " + std::to_string(t.min_content_offset) + "\n" +
+        "nbits_delta_content_offset: " + std::to_string(t.nbits_delta_content_offset) + "\n" +
+        "min_content_length: " + std::to_string(t.min_content_length) + "\n" +
+        "nbits_delta_content_length: " + std::to_string(t.nbits_delta_content_length) + "\n" +
+        "nbits_nshared_objects: " + std::to_string(t.nbits_nshared_objects) + "\n" +
+        "nbits_shared_identifier: " + std::to_string(t.nbits_shared_identifier) + "\n" +
+        "nbits_shared_numerator: " + std::to_string(t.nbits_shared_numerator) + "\n" +
+        "shared_denominator: " + std::to_string(t.shared_denominator) + "\n";
+
+    // Hoist the table minima so the loop adds from registers instead of re-reading the members
+    // past every buffer append.
+    const int min_nobjects = t.min_nobjects;
+    const int min_page_length = t.min_page_length;
+    const int min_content_offset = t.min_content_offset;
+    const int min_content_length = t.min_content_length;
     for (size_t i1 = 0; i1 < linp_.npages; ++i1) {
         HPageOffsetEntry& pe = t.entries.at(i1);
-        info << "Page " << i1 << ":\n"
-             << "  nobjects: " << pe.delta_nobjects + t.min_nobjects << "\n"
-             << "  length: " << pe.delta_page_length + t.min_page_length
-             << "\n"
-             // content offset is relative to page, not file
-             << "  content_offset: " << pe.delta_content_offset + t.min_content_offset << "\n"
-             << "  content_length: " << pe.delta_content_length + t.min_content_length << "\n"
-             << "  nshared_objects: " << pe.nshared_objects << "\n";
+        buf += "Page " + std::to_string(i1) + ":\n" +
+            "  nobjects: " + std::to_string(pe.delta_nobjects + min_nobjects) + "\n" +
+            "  length: " + std::to_string(pe.delta_page_length + min_page_length) +
+            "\n"
+            // content offset is relative to page, not file
+            "  content_offset: " +
+            std::to_string(pe.delta_content_offset + min_content_offset) + "\n" +
+            "  content_length: " + std::to_string(pe.delta_content_length + min_content_length) +
+            "\n" + "  nshared_objects: " + std::to_string(pe.nshared_objects) + "\n";
         for (size_t i2 = 0; i2 < toS(pe.nshared_objects); ++i2) {
-            info << "    identifier " << i2 << ": " << pe.shared_identifiers.at(i2) << "\n";
-            info << "    numerator " << i2 << ": " << pe.shared_numerators.at(i2) << "\n";
+            buf += "    identifier " + std::to_string(i2) + ": " +
+                std::to_string(pe.shared_identifiers.at(i2)) + "\n" + "    numerator " +
+                std::to_string(i2) + ": " + std::to_string(pe.shared_numerators.at(i2)) + "\n";
         }
     }
+    *cf.log()->getInfo() << buf;
 }
 
 void
 Lin::dumpHSharedObject()
 {
-    auto& info = *cf.log()->getInfo();
     HSharedObject& t = shared_object_hints_;
-    info << "first_shared_obj: " << t.first_shared_obj << "\n"
-         << "first_shared_offset: " << adjusted_offset(t.first_shared_offset) << "\n"
-         << "nshared_first_page: " << t.nshared_first_page << "\n"
-         << "nshared_total: " << t.nshared_total << "\n"
-         << "nbits_nobjects: " << t.nbits_nobjects << "\n"
-         << "min_group_length: " << t.min_group_length << "\n"
-         << "nbits_delta_group_length: " << t.nbits_delta_group_length << "\n";
-
+    // As in dumpHPageOffset, one buffer, one write.
+    std::string buf = "first_shared_obj: " + std::to_string(t.first_shared_obj) + "\n" +
+        "first_shared_offset: " + std::to_string(adjusted_offset(t.first_shared_offset)) + "\n" +
+        "nshared_first_page: " + std::to_string(t.nshared_first_page) + "\n" +
+        "nshared_total: " + std::to_string(t.nshared_total) + "\n" +
+        "nbits_nobjects: " + std::to_string(t.nbits_nobjects) + "\n" +
+        "min_group_length: " + std::to_string(t.min_group_length) + "\n" +
+        "nbits_delta_group_length: " + std::to_string(t.nbits_delta_group_length) + "\n";
+
+    const int min_group_length = t.min_group_length;
     for (size_t i = 0; i < toS(t.nshared_total); ++i) {
         HSharedObjectEntry& se = t.entries.at(i);
-        info << "Shared Object " << i << ":\n"
-             << "  group length: " << se.delta_group_length + t.min_group_length << "\n";
+        buf += "Shared Object " + std::to_string(i) + ":\n" + "  group length: " +
+            std::to_string(se.delta_group_length + min_group_length) + "\n";
         // PDF spec says signature present nobjects_minus_one are always 0, so print them only if
         // they have a non-zero value.
         if (se.signature_present) {
-            info << "  signature present\n";
+            buf += "  signature present\n";
         }
         if (se.nobjects_minus_one != 0) {
-            info << "  nobjects: " << se.nobjects_minus_one + 1 << "\n";
+            buf += "  nobjects: " + std::to_string(se.nobjects_minus_one + 1) + "\n";
         }
     }
+    *cf.log()->getInfo() << buf;
 }
 
 void
 Lin::dumpHGeneric(HGeneric& t)
 {
-    *cf.log()->getInfo() << "first_object: " << t.first_object << "\n"
-                         << "first_object_offset: " << adjusted_offset(t.first_object_offset)
-                         << "\n"
-                         << "nobjects: " << t.nobjects << "\n"
-                         << "group_length: " << t.group_length << "\n";
+    *cf.log()->getInfo() << "first_object: " + std::to_string(t.first_object) + "\n" +
+            "first_object_offset: " + std::to_string(adjusted_offset(t.first_object_offset)) +
+            "\n" + "nobjects: " + std::to_string(t.nobjects) + "\n" +
+            "group_length: " + std::to_string(t.group_length) + "\n";
 }
 
 template <typename T>
@@ -1300,12 +1430,10 @@ Lin::calculateLinearizationData(T const& object_stream_data)
         QTC::TC("qpdf", "QPDF categorize pagemode outlines", outlines_in_first_page ? 1 : 0);
     }
 
-    std::set<std::string> open_document_keys;
-    open_document_keys.insert("/ViewerPreferences");
-    open_document_keys.insert("/PageMode");
-    open_document_keys.insert("/Threads");
-    open_document_keys.insert("/OpenAction");
-    open_document_keys.insert("/AcroForm");
+    // Consulted for every root-key object user; five entries in one cache line beat a tree of
+    // string nodes.
+    static constexpr std::array<std::string_view, 5> open_document_keys{
+        "/ViewerPreferences", "/PageMode", "/Threads", "/OpenAction", "/AcroForm"};
 
     std::set<QPDFObjGen> lc_open_document;
     std::set<QPDFObjGen> lc_first_page_private;
@@ -1330,7 +1458,7 @@ Lin::calculateLinearizationData(T const& object_stream_data)
         for (auto const& ou: ous) {
             switch (ou.ou_type) {
             case ObjUser::ou_trailer_key:
-                if (ou.key == "/Encrypt") {
+                if (ou.key == "/Encrypt"sv) {
                     in_open_document = true;
                 } else {
                     ++others;
@@ -1342,9 +1470,10 @@ Lin::calculateLinearizationData(T const& object_stream_data)
                 break;
 
             case ObjUser::ou_root_key:
-                if (open_document_keys.contains(ou.key)) {
+                if (std::find(open_document_keys.begin(), open_document_keys.end(), ou.key) !=
+                    open_document_keys.end()) {
                     in_open_document = true;
-                } else if (ou.key == "/Outlines") {
+                } else if (ou.key == "/Outlines"sv) {
                     in_outlines = true;
                 } else {
                     ++others;
@@ -1426,6 +1555,7 @@ Lin::calculateLinearizationData(T const& object_stream_data)
         lc_root.size() != 1, "found other than one root while calculating linearization data" //
     );
 
+    part4_.reserve(1 + lc_open_document.size());
     part4_.emplace_back(qpdf.getObject(*(lc_root.begin())));
     for (auto const& og: lc_open_document) {
         part4_.emplace_back(qpdf.getObject(og));
@@ -1444,6 +1574,10 @@ Lin::calculateLinearizationData(T const& object_stream_data)
         !lc_first_page_private.erase(first_page_og), "unable to linearize first page" //
     );
     c_linp_.first_page_object = uc_pages.at(0).getObjectID();
+    // Sizes are known from the category sets; reserve so the handle vectors never reallocate.
+    part6_.reserve(
+        1 + lc_first_page_private.size() + lc_first_page_shared.size() +
+        (outlines_in_first_page ? lc_outlines.size() : 0));
     part6_.emplace_back(uc_pages.at(0));
 
     // The PDF spec "recommends" an order for the rest of the objects, but we are going to disregard
@@ -1471,6 +1605,10 @@ Lin::calculateLinearizationData(T const& object_stream_data)
 
     // Part 7: other pages' private objects
 
+    // Every object in lc_other_page_private, including the page objects themselves, ends up in
+    // part 7 exactly once.
+    part7_.reserve(lc_other_page_private.size());
+
     // For each page in order:
     for (size_t i = 1; i < npages; ++i) {
         // Place this page's page object
@@ -1489,12 +1627,13 @@ Lin::calculateLinearizationData(T const& object_stream_data)
         c_page_offset_data_.entries.at(i).nobjects = 1;
 
         ObjUser ou(ObjUser::ou_page, i);
+        auto ou_it = obj_user_to_objects_.find(ou);
         no_ci_stop_if(
-            !obj_user_to_objects_.contains(ou),
+            ou_it == obj_user_to_objects_.end(),
             "found unreferenced page while calculating linearization data" //
         );
 
-        for (auto const& og: obj_user_to_objects_[ou]) {
+        for (auto const& og: ou_it->second) {
             if (lc_other_page_private.erase(og)) {
                 part7_.emplace_back(qpdf.getObject(og));
                 ++c_page_offset_data_.entries.at(i).nobjects;
@@ -1511,6 +1650,7 @@ Lin::calculateLinearizationData(T const& object_stream_data)
     // Part 8: other pages' shared objects
 
     // Order is unimportant.
+    part8_.reserve(lc_other_page_shared.size());
     for (auto const& og: lc_other_page_shared) {
         part8_.emplace_back(qpdf.getObject(og));
     }
@@ -1522,12 +1662,17 @@ Lin::calculateLinearizationData(T const& object_stream_data)
     // page order, then shared thumbnail objects, and then outlines (unless in part 6).  After that,
     // we throw all remaining objects in arbitrary order.
 
+    part9_.reserve(
+        lc_other.size() + lc_thumbnail_private.size() + lc_thumbnail_shared.size() +
+        (outlines_in_first_page ? 0 : lc_outlines.size()));
+
     // Place the pages tree.
-    auto& pages_ogs = obj_user_to_objects_[{ObjUser::ou_root_key, "/Pages"}];
+    auto pages_it = obj_user_to_objects_.find({ObjUser::ou_root_key, "/Pages"});
     no_ci_stop_if(
-        pages_ogs.empty(), "found empty pages tree while calculating linearization data" //
+        pages_it == obj_user_to_objects_.end() || pages_it->second.empty(),
+        "found empty pages tree while calculating linearization data" //
     );
-    for (auto const& og: pages_ogs) {
+    for (auto const& og: pages_it->second) {
         if (lc_other.erase(og)) {
             part9_.emplace_back(qpdf.getObject(og));
         }
@@ -1535,8 +1680,13 @@ Lin::calculateLinearizationData(T const& object_stream_data)
 
     // Place private thumbnail images in page order.  Slightly more information would be required if
     // we were going to bother with thumbnail hint tables.
-    for (size_t i = 0; i < npages; ++i) {
+    // Every object placed by this loop comes out of lc_thumbnail_private, so there is nothing to
+    // do when the set is empty -- the common case for documents without thumbnails.
+    for (size_t i = 0; !lc_thumbnail_private.empty() && i < npages; ++i) {
         QPDFObjectHandle thumb = uc_pages.at(i).getKey("/Thumb");
+        if (thumb.null()) {
+            continue;
+        }
         thumb = getUncompressedObject(thumb, object_stream_data);
         QPDFObjGen thumb_og(thumb.getObjGen());
         // Output the thumbnail itself
@@ -1548,9 +1698,12 @@ Lin::calculateLinearizationData(T const& object_stream_data)
             // there's nothing to prevent it from having been in some set other than
             // lc_thumbnail_private.
         }
-        for (auto const& og: obj_user_to_objects_[{ObjUser::ou_thumb, i}]) {
-            if (lc_thumbnail_private.erase(og)) {
-                part9_.emplace_back(qpdf.getObject(og));
+        if (auto it = obj_user_to_objects_.find({ObjUser::ou_thumb, i});
+            it != obj_user_to_objects_.end()) {
+            for (auto const& og: it->second) {
+                if (lc_thumbnail_private.erase(og)) {
+                    part9_.emplace_back(qpdf.getObject(og));
+                }
             }
         }
     }
@@ -1597,16 +1750,26 @@ Lin::calculateLinearizationData(T const& object_stream_data)
 
     // Note that two objects never have the same object number, so we can map from object number
     // only without regards to generation.
-    std::map<int, int> obj_to_index;
+    // Object numbers are bounded by the xref size, so a flat array indexed by object number
+    // replaces a tree map; -1 marks objects that are not shared.
+    int max_obj = 0;
+    for (auto& oh: part6_) {
+        max_obj = std::max(max_obj, oh.getObjectID());
+    }
+    for (auto& oh: part8_) {
+        max_obj = std::max(max_obj, oh.getObjectID());
+    }
+    std::vector<int> obj_to_index(toS(max_obj) + 1, -1);
 
     c_shared_object_data_.nshared_first_page = toI(part6_.size());
     c_shared_object_data_.nshared_total =
         c_shared_object_data_.nshared_first_page + toI(part8_.size());
 
     std::vector<CHSharedObjectEntry>& shared = c_shared_object_data_.entries;
+    shared.reserve(part6_.size() + part8_.size());
     for (auto& oh: part6_) {
         int obj = oh.getObjectID();
-        obj_to_index[obj] = toI(shared.size());
+        obj_to_index[toS(obj)] = toI(shared.size());
         shared.emplace_back(obj);
     }
     QTC::TC("qpdf", "QPDF lin part 8 empty", part8_.empty() ? 1 : 0);
@@ -1614,7 +1777,7 @@ Lin::calculateLinearizationData(T const& object_stream_data)
         c_shared_object_data_.first_shared_obj = part8_.at(0).getObjectID();
         for (auto& oh: part8_) {
             int obj = oh.getObjectID();
-            obj_to_index[obj] = toI(shared.size());
+            obj_to_index[toS(obj)] = toI(shared.size());
             shared.emplace_back(obj);
         }
     }
@@ -1629,16 +1792,22 @@ Lin::calculateLinearizationData(T const& object_stream_data)
     for (size_t i = 1; i < npages; ++i) {
         CHPageOffsetEntry& pe = c_page_offset_data_.entries.at(i);
         ObjUser ou(ObjUser::ou_page, i);
+        auto ou_it = obj_user_to_objects_.find(ou);
         no_ci_stop_if(
-            !obj_user_to_objects_.contains(ou),
+            ou_it == obj_user_to_objects_.end(),
             "found unreferenced page while calculating linearization data" //
         );
 
-        for (auto const& og: obj_user_to_objects_[ou]) {
-            if (object_to_obj_users_[og].size() > 1 && obj_to_index.contains(og.getObj())) {
-                int idx = obj_to_index[og.getObj()];
-                ++pe.nshared_objects;
-                pe.shared_identifiers.push_back(idx);
+        for (auto const& og: ou_it->second) {
+            auto id = toS(og.getObj());
+            // Consult the flat index first; only candidates that are actually shared pay for the
+            // inverse-map probe, and find() avoids operator[]'s insertion of empty entries.
+            if (int idx = id < obj_to_index.size() ? obj_to_index[id] : -1; idx >= 0) {
+                auto users_it = object_to_obj_users_.find(og);
+                if (users_it != object_to_obj_users_.end() && users_it->second.size() > 1) {
+                    ++pe.nshared_objects;
+                    pe.shared_identifiers.push_back(idx);
+                }
             }
         }
     }
@@ -1697,10 +1866,11 @@ Lin::parts(
     part9 = part9_;
 }
 
-static inline int
+static constexpr int
 nbits(int val)
 {
-    return (val == 0 ? 0 : (1 + nbits(val >> 1)));
+    // Callers only pass non-negative deltas.
+    return static_cast<int>(std::bit_width(static_cast<unsigned int>(val)));
 }
 
 int
@@ -1758,9 +1928,10 @@ Lin::calculateHPageOffset(QPDFWriter::NewObjTable const& new_obj, QPDFWriter::Ob
         // Repeat calculations for page 0 so we can assign to phe[i] without duplicating those
         // assignments.
 
-        int nobjects = cphe.at(i).nobjects;
+        CHPageOffsetEntry const& ce = cphe.at(i);
+        int nobjects = ce.nobjects;
         int length = outputLengthNextN(all_pages.at(i).getObjectID(), nobjects, new_obj, obj);
-        int nshared = cphe.at(i).nshared_objects;
+        int nshared = ce.nshared_objects;
 
         min_nobjects = std::min(min_nobjects, nobjects);
         max_nobjects = std::max(max_nobjects, nobjects);
@@ -1802,9 +1973,9 @@ Lin::calculateHPageOffset(QPDFWriter::NewObjTable const& new_obj, QPDFWriter::Ob
         phe_i.delta_page_length -= min_length;
         phe_i.delta_content_length = phe_i.delta_page_length;
 
-        auto& si = cphe.at(i).shared_identifiers;
-        phe_i.shared_identifiers.insert(phe_i.shared_identifiers.end(), si.begin(), si.end());
-        phe_i.shared_numerators.insert(phe_i.shared_numerators.end(), si.size(), 0);
+        auto& si = cphe[i].shared_identifiers;
+        phe_i.shared_identifiers = si;
+        phe_i.shared_numerators.assign(si.size(), 0);
         ++i;
     }
 }
@@ -1827,7 +1998,7 @@ Lin::calculateHSharedObject(QPDFWriter::NewObjTable const& new_obj, QPDFWriter::
         min_length = std::min(min_length, length);
         max_length = std::max(max_length, length);
         soe.emplace_back();
-        soe.at(i).delta_group_length = length;
+        soe.back().delta_group_length = length;
     }
     no_ci_stop_if(
         soe.size() != toS(cso.nshared_total), "soe has wrong size after initialization" //
@@ -1843,14 +2014,14 @@ Lin::calculateHSharedObject(QPDFWriter::NewObjTable const& new_obj, QPDFWriter::
     so.min_group_length = min_length;
     so.nbits_delta_group_length = nbits(max_length - min_length);
 
-    for (size_t i = 0; i < toS(cso.nshared_total); ++i) {
+    for (auto& se: soe) {
         // Adjust deltas
         no_ci_stop_if(
-            soe.at(i).delta_group_length < min_length,
+            se.delta_group_length < min_length,
             "found too small group length while writing linearization data" //
         );
 
-        soe.at(i).delta_group_length -= min_length;
+        se.delta_group_length -= min_length;
     }
 }
 
@@ -1877,8 +2048,11 @@ write_vector_int(BitWriter& w, int nitems, std::vector<T>& vec, int bits, int_ty
 {
     // nitems times, write bits bits from the given field of the ith vector to the given bit writer.
 
-    for (size_t i = 0; i < QIntC::to_size(nitems); ++i) {
-        w.writeBits(QIntC::to_ulonglong(vec.at(i).*field), QIntC::to_size(bits));
+    size_t count = QIntC::to_size(nitems);
+    size_t nbits = QIntC::to_size(bits);
+    util::assertion(count <= vec.size(), "write_vector_int called with too many items");
+    for (size_t i = 0; i < count; ++i) {
+        w.writeBits(QIntC::to_ulonglong(vec[i].*field), nbits);
     }
     // The PDF spec says that each hint table starts at a byte boundary.  Each "row" actually must
     // start on a byte boundary.
@@ -1897,9 +2071,16 @@ write_vector_vector(
 {
     // nitems1 times, write nitems2 (from the ith element of vec1) items from the vec2 vector field
     // of the ith item of vec1.
-    for (size_t i1 = 0; i1 < QIntC::to_size(nitems1); ++i1) {
-        for (size_t i2 = 0; i2 < QIntC::to_size(vec1.at(i1).*nitems2); ++i2) {
-            w.writeBits(QIntC::to_ulonglong((vec1.at(i1).*vec2).at(i2)), QIntC::to_size(bits));
+    size_t count1 = QIntC::to_size(nitems1);
+    size_t nbits = QIntC::to_size(bits);
+    util::assertion(count1 <= vec1.size(), "write_vector_vector called with too many items");
+    for (size_t i1 = 0; i1 < count1; ++i1) {
+        T& e = vec1[i1];
+        std::vector<int> const& inner = e.*vec2;
+        size_t count2 = QIntC::to_size(e.*nitems2);
+        util::assertion(count2 <= inner.size(), "write_vector_vector inner count too large");
+        for (size_t i2 = 0; i2 < count2; ++i2) {
+            w.writeBits(QIntC::to_ulonglong(inner[i2]), nbits);
         }
     }
     w.flush();
@@ -1976,11 +2157,14 @@ Lin::writeHSharedObject(BitWriter& w)
     write_vector_int(
         w, nitems, entries, t.nbits_delta_group_length, &HSharedObjectEntry::delta_group_length);
     write_vector_int(w, nitems, entries, 1, &HSharedObjectEntry::signature_present);
-    for (size_t i = 0; i < toS(nitems); ++i) {
-        // If signature were present, we'd have to write a 128-bit hash.
-        if (entries.at(i).signature_present != 0) {
-            stopOnError("found unexpected signature present while writing linearization data");
-        }
+    // If a signature were present, we'd have to write a 128-bit hash. OR the flags together so
+    // the scan is branch-free and test once at the end.
+    int signature_acc = 0;
+    for (auto const& entry: entries) {
+        signature_acc |= entry.signature_present;
+    }
+    if (signature_acc != 0) {
+        stopOnError("found unexpected signature present while writing linearization data");
     }
     write_vector_int(w, nitems, entries, t.nbits_nobjects, &HSharedObjectEntry::nobjects_minus_one);
 }
@@ -2003,13 +2187,19 @@ Lin::generateHintStream(
     int& O,
     bool compressed)
 {
-    // Populate actual hint table values
+    // Populate actual hint table values. outline_hints_ may still hold values read from an
+    // existing hint stream, and calculateHOutline leaves it alone when there are no outlines, so
+    // reset it rather than trusting stale state to decide whether to write the outline table.
+    outline_hints_ = {};
     calculateHPageOffset(new_obj, obj);
     calculateHSharedObject(new_obj, obj);
     calculateHOutline(new_obj, obj);
 
     // Write the hint stream itself into a compressed memory buffer. Write through a counter so we
-    // can get offsets.
+    // can get offsets. Reserve a rough upper bound -- a few bytes per page and per shared object
+    // plus the fixed headers -- so the buffer does not have to grow while bits stream in.
+    hint_buffer.reserve(
+        16 * (c_linp_.npages + toS(c_shared_object_data_.nshared_total)) + 128);
     pl::Count c(0, hint_buffer);
     BitWriter w(&c);
 
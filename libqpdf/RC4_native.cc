@@ -38,11 +38,19 @@ RC4_native::RC4_native(unsigned char const* key_data, int key_len)
 void
 RC4_native::process(unsigned char const* in_data, size_t len, unsigned char* out_data)
 {
+    // Work on local copies of the cipher state. Writes through out_data could alias the members
+    // as far as the compiler knows, so keeping x and y in locals lets them stay in registers
+    // across the loop instead of being reloaded for every byte.
+    unsigned char* state = key.state;
+    unsigned char x = key.x;
+    unsigned char y = key.y;
     for (size_t i = 0; i < len; ++i) {
-        key.x = static_cast<unsigned char>((key.x + 1) % 256);
-        key.y = static_cast<unsigned char>((key.state[key.x] + key.y) % 256);
-        swap_byte(key.state[key.x], key.state[key.y]);
-        int xor_index = (key.state[key.x] + key.state[key.y]) % 256;
-        out_data[i] = in_data[i] ^ key.state[xor_index];
+        x = static_cast<unsigned char>(x + 1);
+        y = static_cast<unsigned char>(state[x] + y);
+        swap_byte(state[x], state[y]);
+        unsigned char xor_index = static_cast<unsigned char>(state[x] + state[y]);
+        out_data[i] = in_data[i] ^ state[xor_index];
     }
+    key.x = x;
+    key.y = y;
 }
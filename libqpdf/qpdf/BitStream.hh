@@ -15,6 +15,8 @@ class BitStream
     // Only call getBitsInt when requesting a number of bits that definitely fit in an int.
     int getBitsInt(size_t nbits);
     void skipToNextByte();
+    // Number of bits remaining in the stream.
+    size_t bitsAvailable() const;
 
   private:
     unsigned char const* start;
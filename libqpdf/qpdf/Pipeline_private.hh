@@ -8,6 +8,9 @@
 #include <qpdf/Pl_Flate.hh>
 #include <qpdf/Util.hh>
 
+#include <algorithm>
+#include <cstring>
+
 namespace qpdf::pl
 {
     class String final: public Pipeline
@@ -101,7 +104,15 @@ namespace qpdf::pl
                 }
                 count += static_cast<qpdf_offset_t>(len);
                 if (pass_immediately_to_next) {
-                    next()->writeString(std::string(len, c));
+                    // Repeated fills are short (padding, spaces); write them from a stack buffer
+                    // rather than allocating a temporary string.
+                    unsigned char buf[64];
+                    std::memset(buf, static_cast<unsigned char>(c), std::min(len, sizeof(buf)));
+                    while (len) {
+                        size_t n = std::min(len, sizeof(buf));
+                        next()->write(buf, n);
+                        len -= n;
+                    }
                 }
             }
         }
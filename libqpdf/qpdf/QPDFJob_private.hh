@@ -173,87 +173,93 @@ class QPDFJob::Members
     qpdf::Writer::Config w_cfg;
     std::shared_ptr<QPDFLogger> log;
     std::string message_prefix{"qpdf"};
-    bool warnings{false};
+    bool warnings : 1 {false};
     unsigned long encryption_status{0};
-    bool verbose{false};
+    bool verbose : 1 {false};
     std::string password;
-    bool decrypt{false};
-    bool remove_restrictions{false};
+    bool remove_restrictions : 1 {false};
     int split_pages{0};
-    bool progress{false};
+    bool progress : 1 {false};
     std::function<void(int)> progress_handler{nullptr};
-    bool warnings_exit_zero{false};
-    bool copy_encryption{false};
-    bool encrypt{false};
-    bool suppress_password_recovery{false};
+    bool warnings_exit_zero : 1 {false};
+    // encrypt, decrypt, and copy-encryption are mutually exclusive; track only the most recently
+    // requested action.
+    enum crypto_action_e { ca_none, ca_encrypt, ca_decrypt, ca_copy };
+    crypto_action_e crypto_action{ca_none};
+    bool suppress_password_recovery : 1 {false};
     password_mode_e password_mode{pm_auto};
-    bool allow_insecure{false};
-    bool allow_weak_crypto{false};
+    bool allow_insecure : 1 {false};
+    bool allow_weak_crypto : 1 {false};
     std::string user_password;
     std::string owner_password;
     int keylen{0};
-    bool r2_print{true};
-    bool r2_modify{true};
-    bool r2_extract{true};
-    bool r2_annotate{true};
-    bool r3_accessibility{true};
-    bool r3_extract{true};
-    bool r3_assemble{true};
-    bool r3_annotate_and_form{true};
-    bool r3_form_filling{true};
-    bool r3_modify_other{true};
+    bool r2_print : 1 {true};
+    bool r2_modify : 1 {true};
+    bool r2_extract : 1 {true};
+    bool r2_annotate : 1 {true};
+    bool r3_accessibility : 1 {true};
+    bool r3_extract : 1 {true};
+    bool r3_assemble : 1 {true};
+    bool r3_annotate_and_form : 1 {true};
+    bool r3_form_filling : 1 {true};
+    bool r3_modify_other : 1 {true};
     qpdf_r3_print_e r3_print{qpdf_r3p_full};
-    bool force_V4{false};
-    bool force_R5{false};
-    bool cleartext_metadata{false};
-    bool use_aes{false};
+    bool force_V4 : 1 {false};
+    bool force_R5 : 1 {false};
+    bool cleartext_metadata : 1 {false};
+    bool use_aes : 1 {false};
     int compression_level{-1};
     int jpeg_quality{-1};
     remove_unref_e remove_unreferenced_page_resources{re_auto};
-    bool coalesce_contents{false};
-    bool flatten_annotations{false};
+    bool coalesce_contents : 1 {false};
+    bool flatten_annotations : 1 {false};
     int flatten_annotations_required{0};
     int flatten_annotations_forbidden{an_invisible | an_hidden};
-    bool generate_appearances{false};
+    bool generate_appearances : 1 {false};
     PDFVersion max_input_version;
     std::string min_version;
     std::string force_version;
-    bool show_npages{false};
-    bool static_aes_iv{false};
-    bool show_encryption{false};
-    bool show_encryption_key{false};
-    bool check_linearization{false};
-    bool show_linearization{false};
-    bool show_xref{false};
+    bool show_npages : 1 {false};
+    bool static_aes_iv : 1 {false};
+    bool show_encryption : 1 {false};
+    bool show_encryption_key : 1 {false};
+    bool check_linearization : 1 {false};
+    bool show_linearization : 1 {false};
+    bool show_xref : 1 {false};
     bool show_trailer{false};
     int show_obj{0};
     int show_gen{0};
-    bool show_raw_stream_data{false};
-    bool show_filtered_stream_data{false};
-    bool show_pages{false};
-    bool show_page_images{false};
+    bool show_raw_stream_data : 1 {false};
+    bool show_filtered_stream_data : 1 {false};
+    bool show_pages : 1 {false};
+    bool show_page_images : 1 {false};
     std::vector<size_t> collate;
-    bool flatten_rotation{false};
-    bool list_attachments{false};
+    bool flatten_rotation : 1 {false};
+    bool list_attachments : 1 {false};
     std::string attachment_to_show;
     std::list<std::string> attachments_to_remove;
     std::list<AddAttachment> attachments_to_add;
+    // Timestamp applied to attachments added without an explicit creation or modification date;
+    // computed at most once per job.
+    std::string attachment_now_pdf_time;
     std::list<CopyAttachmentFrom> attachments_to_copy;
     int json_version{0};
-    std::set<std::string> json_keys;
-    std::set<std::string> json_objects;
+    // Small lists (typically well under a dozen entries); kept as deduplicated vectors and
+    // scanned linearly.
+    std::vector<std::string> json_keys;
+    std::vector<std::string> json_objects;
     qpdf_json_stream_data_e json_stream_data{qpdf_sj_none};
-    bool json_stream_data_set{false};
+    bool json_stream_data_set : 1 {false};
     std::string json_stream_prefix;
-    bool test_json_schema{false};
-    bool check{false};
-    bool optimize_images{false};
-    bool externalize_inline_images{false};
-    bool keep_inline_images{false};
-    bool remove_info{false};
-    bool remove_metadata{false};
-    bool remove_page_labels{false};
-    bool remove_structure{false};
+    bool test_json_schema : 1 {false};
+    bool check : 1 {false};
+    bool optimize_images : 1 {false};
+    bool externalize_inline_images : 1 {false};
+    bool keep_inline_images : 1 {false};
+    bool remove_info : 1 {false};
+    bool remove_metadata : 1 {false};
+    bool remove_page_labels : 1 {false};
+    bool remove_structure : 1 {false};
     size_t oi_min_width{DEFAULT_OI_MIN_WIDTH};
     size_t oi_min_height{DEFAULT_OI_MIN_HEIGHT};
     size_t oi_min_area{DEFAULT_OI_MIN_AREA};
@@ -263,16 +269,16 @@ class QPDFJob::Members
     UnderOverlay* under_overlay{nullptr};
     Inputs inputs;
     std::map<std::string, RotationSpec> rotations;
-    bool require_outfile{true};
-    bool replace_input{false};
-    bool check_is_encrypted{false};
-    bool check_requires_password{false};
-    bool empty_input{false};
+    bool require_outfile : 1 {true};
+    bool replace_input : 1 {false};
+    bool check_is_encrypted : 1 {false};
+    bool check_requires_password : 1 {false};
+    bool empty_input : 1 {false};
     std::string outfilename;
-    bool json_input{false};
-    bool json_output{false};
+    bool json_input : 1 {false};
+    bool json_output : 1 {false};
     std::string update_from_json;
-    bool report_mem_usage{false};
+    bool report_mem_usage : 1 {false};
     std::vector<PageLabelSpec> page_label_specs;
 };
 
@@ -265,7 +265,13 @@ class QPDF_String final
 
   public:
     static std::shared_ptr<QPDFObject> create_utf16(std::string const& utf8_val);
-    std::string unparse(bool force_binary = false);
+    // Render a string value in PDF syntax without requiring a QPDF_String wrapper object.
+    static std::string unparse(std::string_view val, bool force_binary = false);
+    std::string
+    unparse(bool force_binary = false)
+    {
+        return unparse(val, force_binary);
+    }
     void writeJSON(int json_version, JSON::Writer& p);
     std::string getUTF8Val() const;
 
@@ -274,7 +280,7 @@ class QPDF_String final
         val(std::move(val))
     {
     }
-    bool useHexString() const;
+    static bool useHexString(std::string_view val);
     std::string val;
 };
 
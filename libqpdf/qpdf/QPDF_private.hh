@@ -608,6 +608,7 @@ class QPDF::Doc::Linearization: Common
         ObjUser(user_e type, std::string const& key);
 
         bool operator<(ObjUser const&) const;
+        bool operator==(ObjUser const&) const;
 
         user_e ou_type;
         size_t pageno{0}; // if ou_page;
@@ -764,12 +765,14 @@ class QPDF::Doc::Linearization: Common
     qpdf_offset_t getLinearizationOffset(QPDFObjGen);
     QPDFObjectHandle
     getUncompressedObject(QPDFObjectHandle&, std::map<int, int> const& object_stream_data);
+    QPDFObjectHandle
+    getUncompressedObject(QPDFObjectHandle&, std::vector<int> const& object_stream_data);
     QPDFObjectHandle getUncompressedObject(QPDFObjectHandle&, QPDFWriter::ObjTable const& obj);
     int lengthNextN(int first_object, int n);
+    void checkHPageOffset(
+        std::vector<QPDFObjectHandle> const& pages, std::vector<int> const& idx_to_obj);
     void
-    checkHPageOffset(std::vector<QPDFObjectHandle> const& pages, std::map<int, int>& idx_to_obj);
-    void
-    checkHSharedObject(std::vector<QPDFObjectHandle> const& pages, std::map<int, int>& idx_to_obj);
+    checkHSharedObject(std::vector<QPDFObjectHandle> const& pages, std::vector<int>& idx_to_obj);
     void checkHOutlines();
     void dumpHPageOffset();
     void dumpHSharedObject();
@@ -803,11 +806,16 @@ class QPDF::Doc::Linearization: Common
         QPDFObjectHandle oh,
         std::function<int(QPDFObjectHandle&)> skip_stream_parameters);
     void filterCompressedObjects(std::map<int, int> const& object_stream_data);
+    // Dense variant indexed by object id; 0 means "not in an object stream". An empty vector
+    // means there are no compressed objects at all.
+    void filterCompressedObjects(std::vector<int> const& object_stream_data);
     void filterCompressedObjects(QPDFWriter::ObjTable const& object_stream_data);
 
-    // Optimization data
-    std::map<ObjUser, std::set<QPDFObjGen>> obj_user_to_objects_;
-    std::map<QPDFObjGen, std::set<ObjUser>> object_to_obj_users_;
+    // Optimization data. The payload vectors are built by appending during traversal and then
+    // sorted and deduplicated once, avoiding a tree node allocation per insert. Code iterating
+    // them relies on the sorted order.
+    std::map<ObjUser, std::vector<QPDFObjGen>> obj_user_to_objects_;
+    std::map<QPDFObjGen, std::vector<ObjUser>> object_to_obj_users_;
 
     // Linearization data
     bool linearization_warnings_{false}; // set by linearizationWarning, used by checkLinearization
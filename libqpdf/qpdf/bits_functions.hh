@@ -41,6 +41,14 @@ read_bits(unsigned char const*& p, size_t& bit_offset, size_t& bits_available, s
         QTC::TC("libtests", "bits zero bits wanted");
     }
 # endif
+    // While the read position is byte-aligned, consume whole bytes directly. The general loop
+    // below spends a masked shift-and-merge iteration per byte; this is a plain load-shift-or.
+    while (bit_offset == 7 && bits_wanted >= 8) {
+        result = (result << 8) | *p;
+        ++p;
+        bits_wanted -= 8;
+        bits_available -= 8;
+    }
     while (bits_wanted > 0) {
         // Grab bits from the first byte clearing anything before
         // bit_offset.
@@ -96,6 +104,11 @@ write_bits(
         QTC::TC("libtests", "bits write zero bits");
     }
 # endif
+    // Completed bytes are collected here and handed to the pipeline in one write at the end of
+    // the call instead of one virtual write call per byte. A 32-bit value plus a partial leading
+    // byte completes at most five bytes.
+    unsigned char outbuf[8];
+    size_t nout = 0;
     while (bits > 0) {
         size_t bits_to_write = std::min(bits, bit_offset + 1);
         unsigned char newval = static_cast<unsigned char>(
@@ -107,7 +120,7 @@ write_bits(
 # ifdef BITS_TESTING
             QTC::TC("libtests", "bits write pipeline");
 # endif
-            pipeline->write(&ch, 1);
+            outbuf[nout++] = ch;
             bit_offset = 7;
             ch = 0;
         } else {
@@ -121,6 +134,9 @@ write_bits(
         QTC::TC("libtests", "bits write iterations", ((bits > 8) ? 0 : (bits > 0) ? 1 : 2));
 # endif
     }
+    if (nout > 0) {
+        pipeline->write(outbuf, nout);
+    }
 }
 #endif
 